@@ -0,0 +1,423 @@
+/**************************************************************************************************
+ *  File:       enemy_benchmark.cpp
+ *  Library:    EnemyBenchmark
+ *
+ *  Purpose:    Times the passes a region makes over every enemy each tick, with enemies stored as
+ *              whole objects in a list against the EnemyStore's one-array-per-field layout
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "enemy_store.h"
+#include "spatial_hash.h"
+#include "definitions.h"
+#include "animation_tracker.h"
+#include "entity_data.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+
+using std::cout, std::endl;
+
+namespace {
+
+constexpr unsigned ENEMY_COUNTS[] = { 1000, 10000 };
+constexpr unsigned TICKS = 300;
+constexpr unsigned REPEATS = 3; // The fastest run is kept, since a single run is at the mercy of the scheduler
+constexpr unsigned SEED = 1234;
+constexpr float FIELD_SIZE = 4000;
+constexpr float MAX_SPEED = 60;
+constexpr float ENEMY_CELL_SIZE = 64; // As in Region
+constexpr util::Seconds TICK_LENGTH = 1.0f / 60;
+
+using Clock = std::chrono::steady_clock;
+
+// Frozen copies of the definition and animation types as they were before EnemyStore, when every enemy held its own
+// copy of both. The game's types have since become compact and shared, which would flatter the legacy side
+namespace legacy {
+
+struct AttackDefinition
+{
+    util::DistanceUnits range;
+    util::DistanceUnits minimum_range;
+    float damage;
+    util::Seconds cooldown;
+    util::Seconds cooldown_timer;
+    util::Seconds duration;
+    util::DistanceUnits knockback_distance;
+    util::DistanceUnits travel_distance;
+};
+
+struct EntityDefinition
+{
+    std::string animation_definition_file;
+    int base_health;
+    float base_movement_speed;
+    float walking_speed;
+    int feeding_range;
+    float siphon_rate;
+    std::map<definitions::Behavior, bool> behaviors;
+    std::map<definitions::Action, bool> actions;
+    std::map<definitions::Action, std::optional<AttackDefinition>> attacks;
+    int steering_force;
+    int repulsion_force;
+    int repulsion_radius;
+    int acceleration;
+    int deceleration;
+    util::Seconds wander_rest_time_min;
+    util::Seconds wander_rest_time_max;
+    util::Seconds swarming_rest_time_min;
+    util::Seconds swarming_rest_time_max;
+    int hopping_distance;
+    util::Seconds hopping_cooldown;
+    int aggro_range;
+    int combat_range;
+    int close_quarters_range;
+    int leash_range;
+    float base_aggression;
+};
+
+struct AnimationData
+{
+    definitions::AnimationIdentifier identifier;
+    unsigned start_frame;
+    unsigned end_frame;
+    definitions::FramesPerSecond speed;
+    std::vector<unsigned> hitbox_frames;
+    sf::Vector2f collision_dimensions;
+    definitions::AnimationIdentifier next;
+};
+
+struct SpritesheetData
+{
+    std::string filepath;
+    std::vector<definitions::Frame> frames;
+    std::map<definitions::AnimationName, std::map<definitions::AnimationVariant, AnimationData>> animations;
+};
+
+struct AnimationTracker
+{
+    AnimationData GetCurrentAnimation() { return current_animation; } // By value, as the old tracker returned it
+
+    SpritesheetData spritesheet_data;
+    AnimationData current_animation{};
+    float animation_timer = 0;
+    unsigned current_frame = 0;
+};
+
+AnimationData copyAnimation(const definitions::AnimationData& animation)
+{
+    return AnimationData{animation.identifier, animation.start_frame, animation.end_frame, animation.speed, animation.hitbox_frames, animation.collision_dimensions, animation.next};
+}
+
+// The same contents the old loader produced, rebuilt from the current definitions
+EntityDefinition copyDefinition(const definitions::EntityDefinition& definition)
+{
+    EntityDefinition copy{};
+    copy.animation_definition_file = definition.animation_definition_file;
+    copy.base_health = definition.base_health;
+    copy.base_movement_speed = definition.base_movement_speed;
+    copy.walking_speed = definition.walking_speed;
+    copy.feeding_range = definition.feeding_range;
+    copy.siphon_rate = definition.siphon_rate;
+    copy.steering_force = definition.steering_force;
+    copy.repulsion_force = definition.repulsion_force;
+    copy.repulsion_radius = definition.repulsion_radius;
+    copy.acceleration = definition.acceleration;
+    copy.deceleration = definition.deceleration;
+    copy.wander_rest_time_min = definition.wander_rest_time_min;
+    copy.wander_rest_time_max = definition.wander_rest_time_max;
+    copy.swarming_rest_time_min = definition.swarming_rest_time_min;
+    copy.swarming_rest_time_max = definition.swarming_rest_time_max;
+    copy.hopping_distance = definition.hopping_distance;
+    copy.hopping_cooldown = definition.hopping_cooldown;
+    copy.aggro_range = definition.aggro_range;
+    copy.combat_range = definition.combat_range;
+    copy.close_quarters_range = definition.close_quarters_range;
+    copy.leash_range = definition.leash_range;
+    copy.base_aggression = definition.base_aggression;
+
+    for (size_t i = 0; i < definitions::BEHAVIOR_COUNT; ++i)
+    {
+        auto behavior = static_cast<definitions::Behavior>(i);
+        if (definition.HasBehavior(behavior))
+        {
+            copy.behaviors[behavior] = true;
+        }
+    }
+
+    for (size_t i = 0; i < definitions::ACTION_COUNT; ++i)
+    {
+        auto action = static_cast<definitions::Action>(i);
+        if (definition.HasAction(action))
+        {
+            copy.actions[action] = true;
+        }
+
+        if (definition.HasAttack(action))
+        {
+            const definitions::AttackDefinition& attack = definition.GetAttack(action);
+            copy.attacks[action] = AttackDefinition{attack.range, attack.minimum_range, attack.damage, attack.cooldown, 0, attack.duration, attack.knockback_distance, attack.travel_distance};
+        }
+    }
+
+    return copy;
+}
+
+// Every enemy parsed and kept its own spritesheet
+AnimationTracker copyAnimationTracker(const definitions::AnimationTracker& tracker)
+{
+    const definitions::SpritesheetData& spritesheet = tracker.GetSpritesheet();
+
+    AnimationTracker copy;
+    copy.spritesheet_data.filepath = spritesheet.filepath;
+    copy.spritesheet_data.frames = spritesheet.frames;
+    for (auto& [name, variants] : spritesheet.handles)
+    {
+        for (auto& [variant, handle] : variants)
+        {
+            copy.spritesheet_data.animations[name][variant] = copyAnimation(spritesheet.animations[handle]);
+        }
+    }
+
+    copy.current_animation = copyAnimation(tracker.GetCurrentAnimation());
+    return copy;
+}
+
+} // legacy
+
+// The layout enemies had before EnemyStore: every field in one object, between the definition copy, the animation
+// tracker and the invulnerability tables, with the objects held in a std::list
+struct LegacyEnemy
+{
+    legacy::EntityDefinition definition;
+    network::EnemyData data{};
+    definitions::Behavior current_behavior = definitions::Behavior::None;
+    definitions::Action current_action = definitions::Action::None;
+    legacy::AnimationTracker animation_tracker;
+    std::vector<sf::Vector2f> waypoints;
+    util::Seconds replan_timer = 0;
+    sf::Vector2f current_velocity{0, 0};
+    float current_speed = 0;
+    float current_max_speed = 0;
+    std::map<uint16_t, util::Seconds> invulnerability_timers;
+    std::map<uint16_t, float> invulnerability_windows;
+    util::Seconds hopping_cooldown_timer = 0;
+
+    sf::FloatRect GetBounds()
+    {
+        sf::Vector2f size = animation_tracker.GetCurrentAnimation().collision_dimensions;
+        return sf::FloatRect(data.position.x - size.x / 2, data.position.y - size.y / 2, size.x, size.y);
+    }
+};
+
+struct EnemySpawn
+{
+    definitions::EntityType type;
+    sf::Vector2f position;
+    sf::Vector2f velocity;
+    definitions::Behavior behavior;
+};
+
+std::vector<EnemySpawn> createSpawns(unsigned count)
+{
+    std::mt19937 rng(SEED);
+    std::uniform_real_distribution<float> position(0, FIELD_SIZE);
+    std::uniform_real_distribution<float> velocity(-MAX_SPEED, MAX_SPEED);
+    std::uniform_int_distribution<unsigned> roll(0, 3);
+    std::vector<definitions::EntityType> enemy_types = definitions::GetSpawnableEnemyTypes();
+
+    std::vector<EnemySpawn> spawns;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        EnemySpawn spawn;
+        spawn.type = enemy_types[i % enemy_types.size()];
+        spawn.position = sf::Vector2f{position(rng), position(rng)};
+        spawn.velocity = sf::Vector2f{velocity(rng), velocity(rng)};
+        spawn.behavior = (roll(rng) == 0) ? definitions::Behavior::Feeding : definitions::Behavior::Wandering;
+        spawns.push_back(spawn);
+    }
+
+    return spawns;
+}
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Each pass mirrors the one the server makes: timers and movement from Enemy::Update, then
+// Region::updateEnemyIndex, Region::updateBattery and Server::broadcastStates
+double runLegacy(const std::vector<EnemySpawn>& spawns, unsigned& out_checksum)
+{
+    std::list<LegacyEnemy> enemies;
+    for (unsigned i = 0; i < spawns.size(); ++i)
+    {
+        LegacyEnemy enemy;
+        enemy.definition = legacy::copyDefinition(definitions::GetEntityDefinition(spawns[i].type));
+        enemy.data.id = i;
+        enemy.data.type = spawns[i].type;
+        enemy.data.position = spawns[i].position;
+        enemy.data.health = enemy.definition.base_health;
+        enemy.current_velocity = spawns[i].velocity;
+        enemy.current_behavior = spawns[i].behavior;
+        enemy.animation_tracker = legacy::copyAnimationTracker(definitions::AnimationTracker::ConstructAnimationTracker(spawns[i].type));
+        enemies.push_back(enemy);
+    }
+
+    util::SpatialHash enemy_index;
+    std::vector<sf::Vector2f> enemy_positions;
+    std::vector<network::EnemyData> enemy_list;
+    unsigned checksum = 0;
+
+    Clock::time_point start = Clock::now();
+    for (unsigned tick = 0; tick < TICKS; ++tick)
+    {
+        for (auto& enemy : enemies)
+        {
+            enemy.hopping_cooldown_timer += TICK_LENGTH;
+            enemy.replan_timer += TICK_LENGTH;
+            enemy.data.position += enemy.current_velocity * TICK_LENGTH;
+        }
+
+        enemy_positions.clear();
+        float enemy_extent = 0;
+        for (auto& enemy : enemies)
+        {
+            sf::FloatRect bounds = enemy.GetBounds();
+            enemy_positions.push_back(sf::Vector2f{bounds.left + bounds.width / 2, bounds.top + bounds.height / 2});
+            enemy_extent = std::max(enemy_extent, std::max(bounds.width, bounds.height) / 2);
+        }
+
+        util::BuildSpatialHash(enemy_index, enemy_positions, ENEMY_CELL_SIZE);
+
+        unsigned feeding = 0;
+        for (auto& enemy : enemies)
+        {
+            if (enemy.current_behavior == definitions::Behavior::Feeding)
+            {
+                ++feeding;
+            }
+        }
+
+        enemy_list.clear();
+        for (auto& enemy : enemies)
+        {
+            enemy_list.push_back(enemy.data);
+        }
+
+        checksum += feeding + enemy_list.size() + static_cast<unsigned>(enemy_extent);
+    }
+
+    out_checksum = checksum;
+    return millisecondsSince(start) / TICKS;
+}
+
+double runStore(const std::vector<EnemySpawn>& spawns, unsigned& out_checksum)
+{
+    server::EnemyStore store;
+    std::vector<definitions::AnimationTracker> animation_trackers; // Cold state, in the same order as the store
+    for (unsigned i = 0; i < spawns.size(); ++i)
+    {
+        unsigned index = store.Add(i, spawns[i].type, spawns[i].position);
+        store.Health[index] = definitions::GetEntityDefinition(spawns[i].type).base_health;
+        store.Velocities[index] = spawns[i].velocity;
+        store.Behaviors[index] = spawns[i].behavior;
+        animation_trackers.push_back(definitions::AnimationTracker::ConstructAnimationTracker(spawns[i].type));
+    }
+
+    util::SpatialHash enemy_index;
+    std::vector<network::EnemyData> enemy_list;
+    unsigned checksum = 0;
+
+    Clock::time_point start = Clock::now();
+    for (unsigned tick = 0; tick < TICKS; ++tick)
+    {
+        // Enemy::Update refreshes its size from its animation tracker every tick
+        for (unsigned i = 0; i < store.Size(); ++i)
+        {
+            store.Sizes[i] = animation_trackers[i].GetCollisionDimensions();
+        }
+
+        store.AdvanceTimers(TICK_LENGTH);
+        for (unsigned i = 0; i < store.Size(); ++i)
+        {
+            store.Positions[i] += store.Velocities[i] * TICK_LENGTH;
+        }
+
+        float enemy_extent = 0;
+        for (auto& size : store.Sizes)
+        {
+            enemy_extent = std::max(enemy_extent, std::max(size.x, size.y) / 2);
+        }
+
+        util::BuildSpatialHash(enemy_index, store.Positions, ENEMY_CELL_SIZE);
+
+        unsigned feeding = 0;
+        for (auto behavior : store.Behaviors)
+        {
+            if (behavior == definitions::Behavior::Feeding)
+            {
+                ++feeding;
+            }
+        }
+
+        enemy_list.clear();
+        for (unsigned i = 0; i < store.Size(); ++i)
+        {
+            enemy_list.push_back(store.GetData(i));
+        }
+
+        checksum += feeding + enemy_list.size() + static_cast<unsigned>(enemy_extent);
+    }
+
+    out_checksum = checksum;
+    return millisecondsSince(start) / TICKS;
+}
+
+template<typename Run>
+double fastestRun(Run run, const std::vector<EnemySpawn>& spawns, unsigned& out_checksum)
+{
+    double fastest = run(spawns, out_checksum);
+    for (unsigned i = 1; i < REPEATS; ++i)
+    {
+        fastest = std::min(fastest, run(spawns, out_checksum));
+    }
+
+    return fastest;
+}
+
+} // anonymous namespace
+
+int main()
+{
+    cout << std::fixed << std::setprecision(3);
+    cout << "Per-tick enemy passes, fastest of " << REPEATS << " runs of " << TICKS << " ticks" << endl;
+
+    for (unsigned count : ENEMY_COUNTS)
+    {
+        std::vector<EnemySpawn> spawns = createSpawns(count);
+
+        unsigned legacy_checksum = 0;
+        unsigned store_checksum = 0;
+        double legacy_ms = fastestRun(runLegacy, spawns, legacy_checksum);
+        double store_ms = fastestRun(runStore, spawns, store_checksum);
+
+        cout << std::setw(6) << count << " enemies: list " << legacy_ms << " ms, store " << store_ms << " ms ("
+             << std::setprecision(1) << legacy_ms / store_ms << "x)" << std::setprecision(3) << endl;
+
+        if (legacy_checksum != store_checksum)
+        {
+            std::cerr << "Layouts disagree for " << count << " enemies" << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,264 @@
+/**************************************************************************************************
+ *  File:       horde_benchmark.cpp
+ *  Library:    HordeBenchmark
+ *
+ *  Purpose:    Runs a region with no clients connected, against hordes of increasing size, and reports
+ *              the tick rate, the cost of each phase of a tick and the memory the region holds
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "region.h"
+#include "region_events.h"
+#include "enemy_store.h"
+#include "global_state.h"
+#include "player.h"
+#include "util.h"
+#include "definitions.h"
+#include "game_math.h"
+#include "nlohmann/json.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using std::cout, std::cerr, std::endl;
+using server::RegionPhase;
+
+namespace {
+
+constexpr definitions::RegionType HORDE_REGION = definitions::RegionType::Leyline; // The only region with a wave spawn zone
+constexpr util::Seconds TICK_LENGTH = 1.0f / 60;
+constexpr float BATTERY_LEVEL = 100;
+const std::filesystem::path CONFIG_PATH("../data/configs/horde_benchmark.json");
+
+const char* PHASE_NAMES[server::REGION_PHASE_COUNT] = {
+    "flow fields", "path requests", "despawn", "enemy index", "detail levels", "enemies", "projectiles", "battery", "spawning"
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Larger hordes run fewer ticks, since enemies packed into the spawn zone cost far more than linearly
+struct HordeConfig
+{
+    unsigned enemies = 0;
+    unsigned warmup_ticks = 0; // Run before timing starts, so the first path searches and flow fields aren't counted
+    unsigned ticks = 0;
+};
+
+struct BenchmarkConfig
+{
+    unsigned seed = 0;
+    std::vector<HordeConfig> hordes;
+    unsigned players = 0;
+    definitions::PackDifficulty pack_difficulty = 0;
+    float player_spread = 0; // Players stand still, this far apart around the convoy
+};
+
+struct BenchmarkResult
+{
+    unsigned enemies = 0;
+    unsigned ticks = 0;
+    double ticks_per_second = 0;
+    double tick_us = 0;
+    std::array<double, server::REGION_PHASE_COUNT> phase_us{};
+    size_t memory = 0; // Bytes held by the region's enemy, projectile and pathing storage
+    double events_per_tick = 0;
+};
+
+// Counts what would have been sent to the players, in place of the sockets a headless region doesn't have
+class CountingSink : public server::RegionEventSink
+{
+public:
+    void EnemyAdded(uint16_t, definitions::EntityType) override { ++Events; }
+    void EnemyRemoved(uint16_t) override { ++Events; }
+    void EnemyAnimationChanged(uint16_t, definitions::AnimationType, util::Direction) override { ++Events; }
+    void PathDisplayed(const util::PathingGraph&, const std::vector<sf::Vector2f>&) override { ++Events; }
+    void MenuEventStarted(uint16_t) override { ++Events; }
+    void MenuEventAdvanced(uint16_t, bool) override { ++Events; }
+
+    uint64_t Events = 0;
+};
+
+bool loadConfig(BenchmarkConfig& out_config)
+{
+    if (!std::filesystem::exists(CONFIG_PATH))
+    {
+        cerr << "Could not open horde benchmark config." << endl;
+        return false;
+    }
+
+    try
+    {
+        std::ifstream file(CONFIG_PATH);
+        nlohmann::json json;
+        file >> json;
+
+        out_config.seed = json["seed"];
+        for (auto& horde : json["hordes"])
+        {
+            out_config.hordes.push_back(HordeConfig{horde["enemies"], horde["warmup_ticks"], horde["ticks"]});
+        }
+
+        out_config.players = json["players"];
+        out_config.pack_difficulty = json["pack_difficulty"];
+        out_config.player_spread = json["player_spread"];
+    }
+    catch(const std::exception& e)
+    {
+        cerr << "Failed to parse horde benchmark config: " << e.what() << endl;
+        return false;
+    }
+
+    if (out_config.players == 0)
+    {
+        cerr << "Horde benchmark needs at least one player for enemies to target." << endl;
+        return false;
+    }
+
+    for (auto& horde : out_config.hordes)
+    {
+        if (horde.ticks == 0)
+        {
+            cerr << "Horde benchmark needs at least one tick for each horde." << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+size_t getMemory(const std::vector<T>& values)
+{
+    return values.capacity() * sizeof(T);
+}
+
+size_t getMemory(const server::EnemyStore& store)
+{
+    return getMemory(store.Ids) + getMemory(store.Types) + getMemory(store.Positions) + getMemory(store.Velocities) +
+           getMemory(store.Speeds) + getMemory(store.MaxSpeeds) + getMemory(store.Health) + getMemory(store.Behaviors) +
+           getMemory(store.Actions) + getMemory(store.Sizes) + getMemory(store.ReplanTimers) + getMemory(store.HoppingCooldowns) +
+           getMemory(store.Details) + getMemory(store.DeferredTime) + getMemory(store.DetailCountdowns) + getMemory(store.DecisionCountdowns);
+}
+
+// Only what the region exposes; memory an enemy allocates for itself, like its waypoints, is not counted
+size_t getMemory(const server::Region& region)
+{
+    size_t memory = getMemory(region.Enemies) + getMemory(region.EnemyStates) + getMemory(region.Projectiles);
+
+    for (auto& [type, graph] : region.PathingGraphs)
+    {
+        memory += getMemory(graph.nodes) + getMemory(graph.edge_offsets) + getMemory(graph.edges);
+    }
+
+    for (auto& [type, hierarchy] : region.HierarchicalPathingGraphs)
+    {
+        memory += getMemory(hierarchy.graph.nodes) + getMemory(hierarchy.graph.edge_offsets) + getMemory(hierarchy.graph.edges) +
+                  getMemory(hierarchy.cluster_offsets) + getMemory(hierarchy.cluster_nodes);
+    }
+
+    return memory;
+}
+
+void createPlayers(const BenchmarkConfig& config)
+{
+    using server::global::PlayerList;
+
+    sf::Vector2f convoy_position = definitions::GetRegionDefinition(HORDE_REGION).convoy.Position;
+
+    PlayerList.clear();
+    util::ClearSlots(server::global::PlayerSlots);
+    for (unsigned i = 0; i < config.players; ++i)
+    {
+        server::Player& player = PlayerList.emplace_back();
+        player.Status = server::Player::PlayerStatus::Alive;
+        player.Data.position = convoy_position + util::AngleToVector(360.0f * i / config.players) * config.player_spread;
+        server::SetPlayerId(player, i);
+    }
+}
+
+BenchmarkResult runBenchmark(const BenchmarkConfig& config, const HordeConfig& horde)
+{
+    util::RandomGenerator.seed(config.seed);
+
+    CountingSink sink;
+    server::Region region(HORDE_REGION, config.players, BATTERY_LEVEL, sink);
+
+    BenchmarkResult result;
+    region.SpawnHorde(horde.enemies, config.pack_difficulty);
+    result.enemies = region.Enemies.size();
+    result.ticks = horde.ticks;
+
+    sf::Time tick_length = sf::seconds(TICK_LENGTH);
+    for (unsigned tick = 0; tick < horde.warmup_ticks; ++tick)
+    {
+        region.Update(tick_length);
+    }
+
+    sink.Events = 0;
+    std::array<int64_t, server::REGION_PHASE_COUNT> phase_totals{};
+
+    Clock::time_point start = Clock::now();
+    for (unsigned tick = 0; tick < horde.ticks; ++tick)
+    {
+        region.Update(tick_length);
+        for (unsigned phase = 0; phase < server::REGION_PHASE_COUNT; ++phase)
+        {
+            phase_totals[phase] += region.Metrics.phase_times[phase];
+        }
+    }
+
+    double elapsed_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    result.tick_us = elapsed_us / horde.ticks;
+    result.ticks_per_second = 1000000 / result.tick_us;
+    for (unsigned phase = 0; phase < server::REGION_PHASE_COUNT; ++phase)
+    {
+        result.phase_us[phase] = static_cast<double>(phase_totals[phase]) / horde.ticks;
+    }
+
+    result.memory = getMemory(region);
+    result.events_per_tick = static_cast<double>(sink.Events) / horde.ticks;
+
+    return result;
+}
+
+void printResult(const BenchmarkResult& result)
+{
+    cout << std::fixed << std::setprecision(1)
+         << std::setw(6) << result.enemies << " enemies, " << std::setw(4) << result.ticks << " ticks: "
+         << std::setw(8) << result.ticks_per_second << " ticks/s"
+         << std::setw(10) << result.tick_us << " us/tick"
+         << std::setw(8) << result.memory / 1024 << " KiB"
+         << std::setw(8) << result.events_per_tick << " events/tick" << endl;
+
+    for (unsigned phase = 0; phase < server::REGION_PHASE_COUNT; ++phase)
+    {
+        cout << "    " << std::left << std::setw(16) << PHASE_NAMES[phase] << std::right << std::setw(10) << result.phase_us[phase] << " us" << endl;
+    }
+}
+
+} // anonymous namespace
+
+int main()
+{
+    BenchmarkConfig config;
+    if (!loadConfig(config))
+    {
+        return 1;
+    }
+
+    createPlayers(config);
+
+    cout << "Headless region with " << config.players << " players standing around the convoy" << endl;
+    for (auto& horde : config.hordes)
+    {
+        printResult(runBenchmark(config, horde));
+    }
+
+    return 0;
+}
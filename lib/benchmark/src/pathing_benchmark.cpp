@@ -0,0 +1,446 @@
+/**************************************************************************************************
+ *  File:       pathing_benchmark.cpp
+ *  Library:    PathingBenchmark
+ *
+ *  Purpose:    Times pathing graph construction and path queries over the shipped regions and random
+ *              obstacle fields, and fails if anything regressed past the configured thresholds
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "pathfinding.h"
+#include "obstacle_grid.h"
+#include "definitions.h"
+#include "animation_tracker.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+using std::cout, std::cerr, std::endl;
+
+namespace {
+
+constexpr float OBSTACLE_CELL_SIZE = 100;
+constexpr unsigned BUILD_REPEATS = 3; // The fastest build is kept, since a single build is at the mercy of the scheduler
+const std::filesystem::path CONFIG_PATH("../data/configs/pathing_benchmark.json");
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkConfig
+{
+    unsigned seed = 0;
+    unsigned queries = 0;
+    sf::Vector2f field_size;
+    std::vector<unsigned> obstacle_counts;
+    float min_obstacle_size = 0;
+    float max_obstacle_size = 0;
+    sf::Vector2f entity_size;
+    float cluster_size = 0; // Hierarchical graphs are skipped if this is 0
+    std::filesystem::path baseline_path;
+
+    double max_time_regression = 0; // Fraction of the baseline a timing may grow by
+    double min_build_difference = 0; // Microseconds, so that noise on tiny timings is never a failure
+    double min_query_difference = 0;
+    double max_work_regression = 0; // Fraction of the baseline a node, edge or memory count may grow by
+};
+
+struct BenchmarkField
+{
+    std::string name;
+    sf::FloatRect bounds;
+    std::vector<sf::FloatRect> obstacles;
+    sf::Vector2f entity_size;
+};
+
+struct Percentiles
+{
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned nodes = 0;
+    unsigned edges = 0;
+    size_t memory = 0; // Bytes held by the graph
+    double build_ms = 0;
+    Percentiles append_us;
+    Percentiles path_us;
+    double mean_expanded = 0;
+    unsigned max_expanded = 0;
+    unsigned failed = 0;
+};
+
+bool loadConfig(BenchmarkConfig& out_config)
+{
+    if (!std::filesystem::exists(CONFIG_PATH))
+    {
+        cerr << "Could not open pathing benchmark config." << endl;
+        return false;
+    }
+
+    try
+    {
+        std::ifstream file(CONFIG_PATH);
+        nlohmann::json json;
+        file >> json;
+
+        out_config.seed = json["seed"];
+        out_config.queries = json["queries"];
+        out_config.field_size = sf::Vector2f{json["field_size"][0], json["field_size"][1]};
+        out_config.obstacle_counts = json["obstacle_counts"].get<std::vector<unsigned>>();
+        out_config.min_obstacle_size = json["obstacle_size"][0];
+        out_config.max_obstacle_size = json["obstacle_size"][1];
+        out_config.entity_size = sf::Vector2f{json["entity_size"][0], json["entity_size"][1]};
+        out_config.cluster_size = json["hierarchical_cluster_size"];
+        out_config.baseline_path = json["baseline"].get<std::string>();
+
+        auto& thresholds = json["thresholds"];
+        out_config.max_time_regression = thresholds["max_time_regression"];
+        out_config.min_build_difference = thresholds["min_build_difference_us"];
+        out_config.min_query_difference = thresholds["min_query_difference_us"];
+        out_config.max_work_regression = thresholds["max_work_regression"];
+    }
+    catch(const std::exception& e)
+    {
+        cerr << "Failed to parse pathing benchmark config: " << e.what() << endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<BenchmarkField> createFields(const BenchmarkConfig& config)
+{
+    std::vector<BenchmarkField> fields;
+
+    std::vector<definitions::RegionDefinition> regions = definitions::GetAllRegionDefinitions();
+    for (unsigned i = 0; i < regions.size(); ++i)
+    {
+        // Unnamed regions fall back to their position in the definitions list
+        definitions::RegionDefinition& region = regions[i];
+        std::string region_name = region.name.empty() ? std::to_string(i) : region.name;
+
+        for (auto type : definitions::GetSpawnableEnemyTypes())
+        {
+            sf::Vector2f entity_size = definitions::AnimationTracker::ConstructAnimationTracker(type).GetAnimation("Move").collision_dimensions;
+            std::string name = "region/" + region_name + "/" + std::to_string(static_cast<int>(entity_size.x)) + "x" + std::to_string(static_cast<int>(entity_size.y));
+
+            if (std::find_if(fields.begin(), fields.end(), [&](const BenchmarkField& field) { return field.name == name; }) == fields.end())
+            {
+                fields.push_back(BenchmarkField{name, region.bounds, region.GetCollisions(), entity_size});
+            }
+        }
+    }
+
+    std::mt19937 generator(config.seed);
+    std::uniform_real_distribution<float> x_distribution(0, config.field_size.x - config.max_obstacle_size);
+    std::uniform_real_distribution<float> y_distribution(0, config.field_size.y - config.max_obstacle_size);
+    std::uniform_real_distribution<float> size_distribution(config.min_obstacle_size, config.max_obstacle_size);
+
+    for (unsigned count : config.obstacle_counts)
+    {
+        BenchmarkField field{"random/" + std::to_string(count), sf::FloatRect{sf::Vector2f{0, 0}, config.field_size}, {}, config.entity_size};
+        for (unsigned i = 0; i < count; ++i)
+        {
+            field.obstacles.push_back(sf::FloatRect{x_distribution(generator), y_distribution(generator), size_distribution(generator), size_distribution(generator)});
+        }
+
+        fields.push_back(field);
+    }
+
+    return fields;
+}
+
+// Start and finish points where an entity fits, shared by every graph built over the same field
+std::vector<std::pair<sf::Vector2f, sf::Vector2f>> createQueries(const BenchmarkField& field, const util::ObstacleGrid& grid, unsigned count, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> x_distribution(field.bounds.left, field.bounds.left + field.bounds.width);
+    std::uniform_real_distribution<float> y_distribution(field.bounds.top, field.bounds.top + field.bounds.height);
+
+    auto open_point = [&]()
+    {
+        sf::Vector2f point;
+        do
+        {
+            point = sf::Vector2f{x_distribution(generator), y_distribution(generator)};
+        }
+        while (util::Intersects(grid, sf::FloatRect{point - field.entity_size / 2.0f, field.entity_size}));
+
+        return point;
+    };
+
+    std::vector<std::pair<sf::Vector2f, sf::Vector2f>> queries;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        sf::Vector2f start = open_point();
+        queries.push_back({start, open_point()});
+    }
+
+    return queries;
+}
+
+Percentiles getPercentiles(std::vector<double> samples)
+{
+    Percentiles percentiles;
+    if (samples.empty())
+    {
+        return percentiles;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double fraction) { return samples[static_cast<size_t>(fraction * (samples.size() - 1))]; };
+
+    percentiles.p50 = at(0.5);
+    percentiles.p90 = at(0.9);
+    percentiles.p99 = at(0.99);
+    percentiles.max = samples.back();
+
+    return percentiles;
+}
+
+size_t getMemory(const util::PathingGraph& graph)
+{
+    return graph.nodes.capacity() * sizeof(sf::Vector2f) + graph.edge_offsets.capacity() * sizeof(unsigned) + graph.edges.capacity() * sizeof(util::PathingEdge);
+}
+
+size_t getMemory(const util::HierarchicalPathingGraph& hierarchy)
+{
+    return getMemory(hierarchy.graph) + hierarchy.cluster_offsets.capacity() * sizeof(unsigned) + hierarchy.cluster_nodes.capacity() * sizeof(int);
+}
+
+double microsecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+BenchmarkResult runBenchmark(const BenchmarkField& field, const BenchmarkConfig& config, unsigned seed, bool hierarchical)
+{
+    BenchmarkResult result;
+    result.name = field.name + (hierarchical ? "/hierarchical" : "/flat");
+
+    util::ObstacleGrid grid = util::CreateObstacleGrid(field.obstacles, OBSTACLE_CELL_SIZE);
+    auto queries = createQueries(field, grid, config.queries, seed);
+
+    util::PathingGraph flat_graph;
+    util::HierarchicalPathingGraph hierarchical_graph;
+
+    double build_us = std::numeric_limits<double>::infinity();
+    for (unsigned i = 0; i < BUILD_REPEATS; ++i)
+    {
+        Clock::time_point build_start = Clock::now();
+        if (hierarchical)
+        {
+            hierarchical_graph = util::CreateHierarchicalPathingGraph(grid, field.bounds, field.entity_size, config.cluster_size);
+        }
+        else
+        {
+            flat_graph = util::CreatePathingGraph(grid, field.entity_size);
+        }
+
+        build_us = std::min(build_us, microsecondsSince(build_start));
+    }
+
+    result.build_ms = build_us / 1000;
+
+    const util::PathingGraph& graph = hierarchical ? hierarchical_graph.graph : flat_graph;
+    result.nodes = graph.nodes.size();
+    result.edges = graph.edges.size() / 2;
+    result.memory = hierarchical ? getMemory(hierarchical_graph) : getMemory(flat_graph);
+
+    std::vector<double> append_samples;
+    std::vector<double> path_samples;
+    util::PathingQuery query;
+    uint64_t total_expanded = 0;
+
+    for (auto& [start, finish] : queries)
+    {
+        sf::FloatRect entity_bounds{start - field.entity_size / 2.0f, field.entity_size};
+
+        Clock::time_point append_start = Clock::now();
+        if (hierarchical)
+        {
+            util::AppendPathingGraph(start, finish, grid, entity_bounds, hierarchical_graph, query);
+        }
+        else
+        {
+            util::AppendPathingGraph(start, finish, grid, entity_bounds, flat_graph, query);
+        }
+
+        append_samples.push_back(microsecondsSince(append_start));
+
+        Clock::time_point path_start = Clock::now();
+        const std::vector<sf::Vector2f>& path = hierarchical ? util::GetPath(hierarchical_graph, grid, query) : util::GetPath(flat_graph, query);
+        path_samples.push_back(microsecondsSince(path_start));
+
+        total_expanded += query.expanded_nodes;
+        result.max_expanded = std::max(result.max_expanded, query.expanded_nodes);
+        if (path.empty())
+        {
+            ++result.failed;
+        }
+    }
+
+    result.append_us = getPercentiles(append_samples);
+    result.path_us = getPercentiles(path_samples);
+    result.mean_expanded = queries.empty() ? 0 : static_cast<double>(total_expanded) / queries.size();
+
+    return result;
+}
+
+nlohmann::json toJson(const BenchmarkResult& result)
+{
+    auto percentiles = [](const Percentiles& value)
+    {
+        return nlohmann::json{{"p50", value.p50}, {"p90", value.p90}, {"p99", value.p99}, {"max", value.max}};
+    };
+
+    return nlohmann::json{
+        {"nodes", result.nodes},
+        {"edges", result.edges},
+        {"memory", result.memory},
+        {"build_us", result.build_ms * 1000},
+        {"append_us", percentiles(result.append_us)},
+        {"path_us", percentiles(result.path_us)},
+        {"mean_expanded", result.mean_expanded},
+        {"failed", result.failed}
+    };
+}
+
+void printResult(const BenchmarkResult& result)
+{
+    cout << std::fixed << std::setprecision(1)
+         << std::left << std::setw(40) << result.name << std::right
+         << std::setw(7) << result.nodes << " nodes"
+         << std::setw(8) << result.edges << " edges"
+         << std::setw(8) << result.memory / 1024 << " KiB"
+         << std::setw(10) << result.build_ms << " ms build"
+         << " | append p50/p99 " << result.append_us.p50 << "/" << result.append_us.p99 << " us"
+         << " | path p50/p99 " << result.path_us.p50 << "/" << result.path_us.p99 << " us"
+         << " | expanded " << result.mean_expanded << " (max " << result.max_expanded << ")";
+
+    if (result.failed > 0)
+    {
+        cout << " | " << result.failed << " unreachable";
+    }
+
+    cout << endl;
+}
+
+// Returns the number of metrics that regressed past the thresholds
+unsigned compareResult(const std::string& name, const nlohmann::json& result, const nlohmann::json& baseline, const BenchmarkConfig& config)
+{
+    unsigned regressions = 0;
+
+    auto check = [&](const std::string& metric, double value, double baseline_value, double allowed_fraction, double allowed_difference)
+    {
+        if (value > baseline_value * (1 + allowed_fraction) && value - baseline_value > allowed_difference)
+        {
+            cerr << "REGRESSION " << name << " " << metric << ": " << value << " (baseline " << baseline_value << ")" << endl;
+            ++regressions;
+        }
+    };
+
+    for (const char* metric : {"nodes", "edges", "memory", "mean_expanded"})
+    {
+        check(metric, result[metric], baseline[metric], config.max_work_regression, 0);
+    }
+
+    check("build_us", result["build_us"], baseline["build_us"], config.max_time_regression, config.min_build_difference);
+
+    // The tail percentiles are reported but too noisy to gate on
+    for (const char* timing : {"append_us", "path_us"})
+    {
+        for (const char* percentile : {"p50", "p90"})
+        {
+            check(std::string{timing} + "." + percentile, result[timing][percentile], baseline[timing][percentile], config.max_time_regression, config.min_query_difference);
+        }
+    }
+
+    return regressions;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    bool update_baseline = (argc > 1 && std::string{argv[1]} == "--update-baseline");
+
+    BenchmarkConfig config;
+    if (!loadConfig(config))
+    {
+        return 1;
+    }
+
+    nlohmann::json results;
+    std::vector<BenchmarkField> fields = createFields(config);
+
+    for (unsigned i = 0; i < fields.size(); ++i)
+    {
+        for (bool hierarchical : {false, true})
+        {
+            if (hierarchical && config.cluster_size <= 0)
+            {
+                continue;
+            }
+
+            BenchmarkResult result = runBenchmark(fields[i], config, config.seed + i, hierarchical);
+            printResult(result);
+            results[result.name] = toJson(result);
+        }
+    }
+
+    if (update_baseline || !std::filesystem::exists(config.baseline_path))
+    {
+        std::filesystem::create_directories(config.baseline_path.parent_path());
+        std::ofstream file(config.baseline_path);
+        file << results.dump(2) << endl;
+        cout << "Saved baseline to " << config.baseline_path << endl;
+        return 0;
+    }
+
+    nlohmann::json baseline;
+    try
+    {
+        std::ifstream file(config.baseline_path);
+        file >> baseline;
+    }
+    catch(const std::exception& e)
+    {
+        cerr << "Failed to parse pathing benchmark baseline: " << e.what() << endl;
+        return 1;
+    }
+
+    unsigned regressions = 0;
+    for (auto& [name, result] : results.items())
+    {
+        if (baseline.contains(name))
+        {
+            regressions += compareResult(name, result, baseline[name], config);
+        }
+        else
+        {
+            cout << "No baseline for " << name << endl;
+        }
+    }
+
+    if (regressions > 0)
+    {
+        cerr << regressions << " metrics regressed past the thresholds in " << CONFIG_PATH << endl;
+        return 1;
+    }
+
+    cout << "No regressions against " << config.baseline_path << endl;
+    return 0;
+}
@@ -12,7 +12,7 @@
 #include "cursor_button.h"
 #include "toggle_button.h"
 #include "definitions.h"
-#include "pathfinding.h"
+#include "route_table.h"
 #include "SFML/Graphics/Text.hpp"
 #include "SFML/Graphics/RectangleShape.hpp"
 
@@ -70,7 +70,7 @@ private:
     Spritesheet marker;
     std::vector<Node> region_nodes;
     std::vector<Link> links;
-    std::vector<util::DjikstraNode> node_graph;
+    util::RouteTable routes;
 
     uint16_t current_vote;
 
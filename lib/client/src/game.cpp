@@ -316,6 +316,11 @@ void Game::AddEnemy(uint16_t enemy_id, definitions::EntityType type)
     }
 }
 
+void Game::RemoveEnemy(uint16_t enemy_id)
+{
+    enemies.erase(enemy_id);
+}
+
 void Game::UpdateEnemies(std::vector<network::EnemyData> enemy_list)
 {
     for (auto& enemy : enemy_list)
@@ -461,6 +461,15 @@ void GameManager::checkMessages()
                 }
             }
             break;
+            case ServerMessage::Code::RemoveEnemy:
+            {
+                uint16_t enemy_id;
+                if (ServerMessage::DecodeRemoveEnemy(resources::GetServerSocket(), enemy_id))
+                {
+                    Game.RemoveEnemy(enemy_id);
+                }
+            }
+            break;
             case ServerMessage::Code::EnemyUpdate:
             {
                 std::vector<network::EnemyData> enemy_list;
@@ -119,40 +119,7 @@ void Overmap::Load(definitions::Zone zone)
         links.push_back(link);
     }
 
-    unsigned num_nodes = definitions::Zone::ZONE_WIDTH / 200 * definitions::Zone::ZONE_HEIGHT / 200;
-    for (unsigned i = 0; i < num_nodes; ++i)
-    {
-        util::DjikstraNode node{};
-
-        Node current_node{};
-        bool node_found = false;
-        for (auto& n : region_nodes)
-        {
-            if (n.definition.id == i)
-            {
-                current_node = n;
-                node_found = true;
-                break;
-            }
-        }
-
-        if (node_found)
-        {
-            for (auto& link : links)
-            {
-                if (link.definition.start == getNodeById(i).definition.id)
-                {
-                    node.connections[link.definition.finish] = link.definition.distance;
-                }
-                else if (link.definition.finish == getNodeById(i).definition.id)
-                {
-                    node.connections[link.definition.start] = link.definition.distance;
-                }
-            }
-        }
-
-        node_graph.push_back(node);
-    }
+    routes = definitions::CreateRouteTable(zone);
 }
 
 void Overmap::Update(sf::Time elapsed)
@@ -302,9 +269,9 @@ void Overmap::OnMouseUp(sf::Event::MouseButtonEvent event)
 
 void Overmap::onClickNode(uint16_t region_id)
 {
-    if (node_graph[current_region].connections.find(region_id) != node_graph[current_region].connections.end())
+    if (util::IsAdjacent(routes, current_region, region_id))
     {
-        if (node_graph[current_region].connections[region_id] > battery)
+        if (util::GetLinkCost(routes, current_region, region_id) > battery)
         {
             information.setString("Not enough battery charge.");
             information.setOrigin(information.getGlobalBounds().width / 2, information.getGlobalBounds().height / 2);
@@ -349,7 +316,7 @@ void Overmap::onHoverNodeEnter(uint16_t node_id)
     }
     else
     {
-        std::vector<uint16_t> path = util::GetPath(node_graph, current_region, node_id);
+        std::vector<uint16_t> path = util::GetRoute(routes, current_region, node_id);
         float available_battery = battery;
 
         for (unsigned i = 1; i < path.size(); ++i)
@@ -177,7 +177,7 @@ bool Spritesheet::loadTexture(std::string filename)
 
 void Spritesheet::setFrame(bool initialize)
 {
-    definitions::Frame new_frame = animation_tracker.GetFrame();
+    const definitions::Frame& new_frame = animation_tracker.GetFrame();
 
     if (initialize || new_frame.index != current_frame_index)
     {
@@ -11,9 +11,13 @@
 
 #include <SFML/System/Time.hpp>
 #include "definitions.h"
+#include <memory>
 
 namespace definitions {
 
+// Spritesheets are parsed once per file and shared, read-only, by every tracker made from them. A tracker only owns
+// its place in the current animation. Animations are found by handle or AnimationType in constant time; lookups by
+// name search the sheet's maps and are meant for loading and tools
 class AnimationTracker
 {
 public:
@@ -24,14 +28,25 @@ public:
 
     void Update(sf::Time elapsed);
 
-    std::string GetFilepath();
-    definitions::Frame GetFrame();
-    std::vector<sf::FloatRect> GetAttackHitboxes();
-    definitions::AnimationData GetCurrentAnimation();
-    definitions::AnimationData GetAnimation(AnimationName name);
-    definitions::AnimationData GetAnimation(AnimationIdentifier identifier);
-    util::Seconds GetAnimationTime(AnimationName name);
-    util::Seconds GetAnimationTime(AnimationIdentifier identifier);
+    const std::string& GetFilepath() const;
+    const definitions::SpritesheetData& GetSpritesheet() const; // Shared with every tracker made from the same file
+    const definitions::Frame& GetFrame() const;
+    const std::vector<sf::FloatRect>& GetAttackHitboxes() const;
+    const definitions::AnimationData& GetCurrentAnimation() const;
+    sf::Vector2f GetCollisionDimensions() const; // Of the current animation
+    AnimationHandle GetAnimationHandle(AnimationType type, AnimationVariant variant) const;
+    AnimationHandle GetAnimationHandle(AnimationIdentifier identifier) const;
+    const definitions::AnimationData& GetAnimation(AnimationHandle handle) const;
+    const definitions::AnimationData& GetAnimation(AnimationType type) const;
+    const definitions::AnimationData& GetAnimation(AnimationName name) const;
+    const definitions::AnimationData& GetAnimation(AnimationIdentifier identifier) const;
+    util::Seconds GetAnimationTime(AnimationType type) const;
+    util::Seconds GetAnimationTime(AnimationType type, AnimationVariant variant) const;
+    util::Seconds GetAnimationTime(AnimationName name) const;
+    util::Seconds GetAnimationTime(AnimationIdentifier identifier) const;
+    void SetAnimation(AnimationHandle handle);
+    void SetAnimation(AnimationType type);
+    void SetAnimation(AnimationType type, AnimationVariant variant);
     void SetAnimation(AnimationIdentifier identifier);
     void SetAnimation(AnimationName name, AnimationVariant variant);
     void SetAnimation(AnimationName name);
@@ -39,9 +54,10 @@ public:
 private:
     void setFrame(unsigned frame);
 
-    definitions::SpritesheetData spritesheet_data;
+    std::shared_ptr<const definitions::SpritesheetData> spritesheet_data;
 
-    definitions::AnimationData current_animation{};
+    AnimationHandle current_handle = NO_ANIMATION_HANDLE;
+    const definitions::AnimationData* current_animation; // Points into spritesheet_data
     float animation_timer = 0;
     unsigned current_frame = 0;
 
@@ -8,6 +8,9 @@
  *************************************************************************************************/
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <limits>
 #include <map>
 #include <vector>
 #include <string>
@@ -15,6 +18,7 @@
 #include "SFML/System/Vector2.hpp"
 #include "SFML/Graphics/Rect.hpp"
 #include "game_math.h"
+#include "route_table.h"
 
 namespace definitions
 {
@@ -26,6 +30,8 @@ enum class EntityType : uint8_t
     Bat
 };
 
+constexpr size_t ENTITY_TYPE_COUNT = static_cast<size_t>(EntityType::Bat) + 1;
+
 enum class Behavior
 {
     None,
@@ -38,6 +44,8 @@ enum class Behavior
     Dead
 };
 
+constexpr size_t BEHAVIOR_COUNT = static_cast<size_t>(Behavior::Dead) + 1;
+
 enum class Action
 {
     None,
@@ -50,13 +58,14 @@ enum class Action
     TailSwipe
 };
 
+constexpr size_t ACTION_COUNT = static_cast<size_t>(Action::TailSwipe) + 1;
+
 struct AttackDefinition
 {
     util::DistanceUnits range;
     util::DistanceUnits minimum_range;
     float damage;
-    util::Seconds cooldown;
-    util::Seconds cooldown_timer;
+    util::Seconds cooldown; // Each enemy times its own cooldowns
     util::Seconds duration;
     util::DistanceUnits knockback_distance;
     util::DistanceUnits travel_distance;
@@ -69,8 +78,30 @@ struct AttackEvent
     sf::Vector2f origin;
 };
 
+enum class AiDetail : uint8_t
+{
+    Full,
+    Reduced, // Updated every reduced_interval, moving in straight lines without repulsion
+    Minimal  // As Reduced, but updated every minimal_interval
+};
+
+// Idle enemies further than a range from every player and the convoy drop to that level of detail
+struct AiDetailThresholds
+{
+    util::DistanceUnits reduced_range = std::numeric_limits<float>::infinity();
+    util::Seconds reduced_interval = 0;
+    util::DistanceUnits minimal_range = std::numeric_limits<float>::infinity();
+    util::Seconds minimal_interval = 0;
+};
+
+// Built once when entity files are loaded and shared by every entity of the type, so it never changes afterwards
 struct EntityDefinition
 {
+    bool HasBehavior(Behavior behavior) const { return behaviors[static_cast<size_t>(behavior)]; }
+    bool HasAction(Action action) const { return actions[static_cast<size_t>(action)]; }
+    bool HasAttack(Action action) const { return attacks[static_cast<size_t>(action)].has_value(); }
+    const AttackDefinition& GetAttack(Action action) const { return attacks[static_cast<size_t>(action)].value(); }
+
     //std::string name;
     std::string animation_definition_file;
     int base_health;
@@ -78,9 +109,9 @@ struct EntityDefinition
     float walking_speed;
     int feeding_range;
     float siphon_rate;
-    std::map<Behavior, bool> behaviors;
-    std::map<Action, bool> actions;
-    std::map<Action, std::optional<AttackDefinition>> attacks;
+    std::bitset<BEHAVIOR_COUNT> behaviors;
+    std::bitset<ACTION_COUNT> actions;
+    std::array<std::optional<AttackDefinition>, ACTION_COUNT> attacks; // Indexed by the attack's action
     int steering_force;
     int repulsion_force;
     int repulsion_radius;
@@ -97,9 +128,11 @@ struct EntityDefinition
     int close_quarters_range;
     int leash_range;
     float base_aggression;
+    AiDetailThresholds ai_detail;
+    util::Seconds decision_interval; // Between choices of behavior and target, 0 to choose every tick
 };
 
-EntityDefinition GetEntityDefinition(EntityType type);
+const EntityDefinition& GetEntityDefinition(EntityType type);
 
 using AnimationName = std::string;
 using FramesPerSecond = float;
@@ -111,10 +144,28 @@ enum class AnimationVariant
     Northeast, Northwest, Southeast, Southwest
 };
 
+constexpr size_t ANIMATION_VARIANT_COUNT = static_cast<size_t>(AnimationVariant::Southwest) + 1;
+
 AnimationVariant ToVariant(std::string variant);
 std::string ToString(AnimationVariant variant);
 AnimationVariant GetAnimationVariant(util::Direction direction);
 
+// The animations the server plays on enemies, so they can be set and sent without strings. Any other name is None
+enum class AnimationType
+{
+    None, Rest, Move, Feed, Knockback, Stun, Tackle, Death,
+    Sniff, LeapWindup, Leap, LeapResting, HopWindup, Hop, TailSwipe
+};
+
+constexpr size_t ANIMATION_TYPE_COUNT = static_cast<size_t>(AnimationType::TailSwipe) + 1;
+
+AnimationType ToAnimationType(AnimationName name);
+AnimationName ToString(AnimationType type);
+
+// An animation's index within its spritesheet, fixed once the sheet is loaded
+using AnimationHandle = uint16_t;
+constexpr AnimationHandle NO_ANIMATION_HANDLE = std::numeric_limits<AnimationHandle>::max();
+
 struct AnimationIdentifier
 {
     AnimationName name;
@@ -130,6 +181,7 @@ struct AnimationData
     std::vector<unsigned> hitbox_frames;
     sf::Vector2f collision_dimensions;
     AnimationIdentifier next;
+    AnimationHandle next_handle; // NO_ANIMATION_HANDLE if the sheet has no such animation
 };
 
 struct Frame
@@ -144,7 +196,9 @@ struct SpritesheetData
 {
     std::string filepath;
     std::vector<Frame> frames;
-    std::map<AnimationName, std::map<AnimationVariant, AnimationData>> animations;
+    std::vector<AnimationData> animations; // By handle
+    std::map<AnimationName, std::map<AnimationVariant, AnimationHandle>> handles;
+    std::array<std::array<AnimationHandle, ANIMATION_VARIANT_COUNT>, ANIMATION_TYPE_COUNT> typed_handles; // By type, then variant
 };
 
 enum class WeaponType
@@ -327,6 +381,8 @@ struct EnemyPack
 
 EnemyPack GetEnemyPackByDifficulty(PackDifficulty difficulty);
 EnemyPack GetEnemyPackById(PackIdentifier id);
+std::vector<EnemyPack> GetEnemyPacksByDifficulty(PackDifficulty difficulty);
+std::vector<EnemyPack> GetAllEnemyPacks();
 
 enum class RegionType : uint8_t
 {
@@ -346,6 +402,8 @@ struct RegionDefinition
     std::vector<Npc> npcs;
     std::vector<MenuEvent> events;
     std::vector<EnemyPack> enemy_packs;
+
+    std::vector<sf::FloatRect> GetCollisions();
 };
 
 struct Zone
@@ -372,5 +430,11 @@ struct Zone
 };
 
 RegionDefinition GetRegionDefinition(RegionType region);
+std::vector<RegionDefinition> GetAllRegionDefinitions();
+
+// Sorted and unique. A leyline can draw any pack of its difficulty, so every pack counts toward it
+std::vector<EntityType> GetSpawnableEnemyTypes(const RegionDefinition& region);
+std::vector<EntityType> GetSpawnableEnemyTypes(); // Of every region and pack
+util::RouteTable CreateRouteTable(const Zone& zone);
 
 } // namespace definitions
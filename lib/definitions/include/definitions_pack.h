@@ -0,0 +1,28 @@
+/**************************************************************************************************
+ *  File:       definitions_pack.h
+ *
+ *  Purpose:    Every JSON definition and spritesheet compiled into one binary pack, memory mapped at
+ *              startup instead of parsing each file
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "nlohmann/json.hpp"
+#include <filesystem>
+
+namespace definitions
+{
+
+// The pack holds every .json file under data/definitions and data/sprites, encoded as MessagePack, along with the
+// size and modification time each file had when it was compiled
+std::filesystem::path GetDefinitionsPackPath();
+bool BuildDefinitionsPack(); // Replaces the pack with one compiled from the current files
+
+// From the pack when it holds the file as it is now, otherwise parsed from the file. A missing pack is built the first
+// time anything is loaded; one with edited or added files is only rebuilt by BuildDefinitionsPack. Throws the same as
+// parsing would
+nlohmann::json LoadJson(const std::filesystem::path& path);
+
+} // definitions
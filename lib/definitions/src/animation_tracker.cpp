@@ -8,36 +8,107 @@
  *
  *************************************************************************************************/
 #include "animation_tracker.h"
+#include "definitions_pack.h"
 #include "nlohmann/json.hpp"
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <map>
 
 using std::cout, std::cerr, std::endl;
 
 namespace definitions {
+namespace {
 
-AnimationTracker::AnimationTracker()
+const AnimationData NO_ANIMATION{}; // Current until the first SetAnimation, and returned for animations a sheet lacks
+
+std::shared_ptr<SpritesheetData> createSpritesheet()
+{
+    auto spritesheet = std::make_shared<SpritesheetData>();
+    for (auto& variants : spritesheet->typed_handles)
+    {
+        variants.fill(NO_ANIMATION_HANDLE);
+    }
+
+    return spritesheet;
+}
+
+void addAnimation(SpritesheetData& spritesheet, const AnimationData& animation)
 {
+    AnimationHandle handle = static_cast<AnimationHandle>(spritesheet.animations.size());
+    spritesheet.animations.push_back(animation);
+    spritesheet.handles[animation.identifier.name][animation.identifier.variant] = handle;
+
+    AnimationType type = ToAnimationType(animation.identifier.name);
+    if (type != AnimationType::None)
+    {
+        spritesheet.typed_handles[static_cast<size_t>(type)][static_cast<size_t>(animation.identifier.variant)] = handle;
+    }
+}
+
+AnimationHandle findHandle(const SpritesheetData& spritesheet, AnimationIdentifier identifier)
+{
+    auto name_iterator = spritesheet.handles.find(identifier.name);
+    if (name_iterator == spritesheet.handles.end())
+    {
+        return NO_ANIMATION_HANDLE;
+    }
+
+    auto variant_iterator = name_iterator->second.find(identifier.variant);
+    if (variant_iterator == name_iterator->second.end())
+    {
+        return NO_ANIMATION_HANDLE;
+    }
+
+    return variant_iterator->second;
+}
+
+// Once every animation has its handle, each can find the animation that follows it
+void linkAnimations(SpritesheetData& spritesheet)
+{
+    for (auto& animation : spritesheet.animations)
+    {
+        animation.next_handle = findHandle(spritesheet, animation.next);
+        if (animation.next_handle == NO_ANIMATION_HANDLE)
+        {
+            cerr << "Animation not found: " << animation.next.name << ", " << ToString(animation.next.variant)
+                 << ", following " << animation.identifier.name << " in " << spritesheet.filepath << endl;
+        }
+    }
+}
+
+std::shared_ptr<const SpritesheetData> createDefaultSpritesheet()
+{
+    auto spritesheet = createSpritesheet();
+
     Frame frame{};
     AnimationData animation{};
     animation.identifier = AnimationIdentifier{"Default", AnimationVariant::Default};
     animation.next = AnimationIdentifier{"Default", AnimationVariant::Default};
 
-    spritesheet_data.frames.push_back(frame);
-    spritesheet_data.animations[animation.identifier.name][animation.identifier.variant] = animation;
+    spritesheet->frames.push_back(frame);
+    addAnimation(*spritesheet, animation);
+    linkAnimations(*spritesheet);
+
+    return spritesheet;
+}
+
+} // anonymous namespace
+
+AnimationTracker::AnimationTracker() : current_animation{&NO_ANIMATION}
+{
+    static const std::shared_ptr<const SpritesheetData> default_spritesheet = createDefaultSpritesheet();
+    spritesheet_data = default_spritesheet;
 }
 
 void AnimationTracker::Update(sf::Time elapsed)
 {
     animation_timer += elapsed.asSeconds();
-    if (current_animation.speed != 0 && animation_timer >= 1 / current_animation.speed)
+    if (current_animation->speed != 0 && animation_timer >= 1 / current_animation->speed)
     {
-        animation_timer -= 1 / current_animation.speed;
-        if (current_frame == current_animation.end_frame)
+        animation_timer -= 1 / current_animation->speed;
+        if (current_frame == current_animation->end_frame)
         {
-            SetAnimation(current_animation.next);
+            SetAnimation(current_animation->next_handle);
         }
         else
         {
@@ -46,68 +117,140 @@ void AnimationTracker::Update(sf::Time elapsed)
     }
 }
 
-std::string AnimationTracker::GetFilepath()
+const std::string& AnimationTracker::GetFilepath() const
+{
+    return spritesheet_data->filepath;
+}
+
+const SpritesheetData& AnimationTracker::GetSpritesheet() const
+{
+    return *spritesheet_data;
+}
+
+const Frame& AnimationTracker::GetFrame() const
+{
+    return spritesheet_data->frames[current_frame];
+}
+
+const std::vector<sf::FloatRect>& AnimationTracker::GetAttackHitboxes() const
+{
+    return spritesheet_data->frames[current_frame].attack_hitboxes;
+}
+
+const AnimationData& AnimationTracker::GetCurrentAnimation() const
+{
+    return *current_animation;
+}
+
+sf::Vector2f AnimationTracker::GetCollisionDimensions() const
+{
+    return current_animation->collision_dimensions;
+}
+
+AnimationHandle AnimationTracker::GetAnimationHandle(AnimationType type, AnimationVariant variant) const
 {
-    return spritesheet_data.filepath;
+    return spritesheet_data->typed_handles[static_cast<size_t>(type)][static_cast<size_t>(variant)];
 }
 
-Frame AnimationTracker::GetFrame()
+AnimationHandle AnimationTracker::GetAnimationHandle(AnimationIdentifier identifier) const
 {
-    return spritesheet_data.frames[current_frame];
+    return findHandle(*spritesheet_data, identifier);
 }
 
-std::vector<sf::FloatRect> AnimationTracker::GetAttackHitboxes()
+const AnimationData& AnimationTracker::GetAnimation(AnimationHandle handle) const
 {
-    return spritesheet_data.frames[current_frame].attack_hitboxes;
+    if (handle >= spritesheet_data->animations.size())
+    {
+        return NO_ANIMATION;
+    }
+
+    return spritesheet_data->animations[handle];
 }
 
-AnimationData AnimationTracker::GetCurrentAnimation()
+const AnimationData& AnimationTracker::GetAnimation(AnimationType type) const
 {
-    return current_animation;
+    return GetAnimation(GetAnimationHandle(type, AnimationVariant::Default));
 }
 
-definitions::AnimationData AnimationTracker::GetAnimation(AnimationName name)
+const AnimationData& AnimationTracker::GetAnimation(AnimationName name) const
 {
     return GetAnimation(AnimationIdentifier{name, AnimationVariant::Default});
 }
 
-definitions::AnimationData AnimationTracker::GetAnimation(AnimationIdentifier identifier)
+const AnimationData& AnimationTracker::GetAnimation(AnimationIdentifier identifier) const
 {
-    return spritesheet_data.animations[identifier.name][identifier.variant];
+    return GetAnimation(GetAnimationHandle(identifier));
 }
 
-util::Seconds AnimationTracker::GetAnimationTime(AnimationName name)
+util::Seconds AnimationTracker::GetAnimationTime(AnimationType type) const
+{
+    return GetAnimationTime(type, AnimationVariant::Default);
+}
+
+util::Seconds AnimationTracker::GetAnimationTime(AnimationType type, AnimationVariant variant) const
+{
+    const AnimationData& animation = GetAnimation(GetAnimationHandle(type, variant));
+    return (animation.end_frame - animation.start_frame + 1) / animation.speed;
+}
+
+util::Seconds AnimationTracker::GetAnimationTime(AnimationName name) const
 {
     return GetAnimationTime(AnimationIdentifier{name, AnimationVariant::Default});
 }
 
-util::Seconds AnimationTracker::GetAnimationTime(AnimationIdentifier identifier)
+util::Seconds AnimationTracker::GetAnimationTime(AnimationIdentifier identifier) const
 {
-    AnimationData animation = spritesheet_data.animations[identifier.name][identifier.variant];
+    const AnimationData& animation = GetAnimation(identifier);
     return (animation.end_frame - animation.start_frame + 1) / animation.speed;
 }
 
-void AnimationTracker::SetAnimation(AnimationIdentifier identifier)
+void AnimationTracker::SetAnimation(AnimationHandle handle)
 {
-    if (current_animation.identifier.name == identifier.name && current_animation.identifier.variant == identifier.variant)
+    // Setting the current animation again only restarts it once it has finished
+    if (handle == current_handle && current_frame != current_animation->end_frame)
     {
-        if (current_frame != current_animation.end_frame)
-        {
-            return;
-        }
+        return;
     }
 
-    if (spritesheet_data.animations.find(identifier.name) != spritesheet_data.animations.end() &&
-        spritesheet_data.animations[identifier.name].find(identifier.variant) != spritesheet_data.animations[identifier.name].end())
+    // Missing animations were reported when they were looked up, or when the sheet was linked
+    if (handle >= spritesheet_data->animations.size())
     {
-        current_animation = spritesheet_data.animations[identifier.name][identifier.variant];
-        setFrame(current_animation.start_frame);
-        animation_timer = 0;
+        return;
     }
-    else
+
+    current_handle = handle;
+    current_animation = &spritesheet_data->animations[handle];
+    setFrame(current_animation->start_frame);
+    animation_timer = 0;
+}
+
+void AnimationTracker::SetAnimation(AnimationType type)
+{
+    SetAnimation(type, AnimationVariant::Default);
+}
+
+void AnimationTracker::SetAnimation(AnimationType type, AnimationVariant variant)
+{
+    AnimationHandle handle = GetAnimationHandle(type, variant);
+    if (handle == NO_ANIMATION_HANDLE)
+    {
+        cerr << "Animation not found: " << ToString(type) << ", " << ToString(variant) << endl;
+        return;
+    }
+
+    SetAnimation(handle);
+}
+
+void AnimationTracker::SetAnimation(AnimationIdentifier identifier)
+{
+    AnimationHandle handle = GetAnimationHandle(identifier);
+    if (handle == NO_ANIMATION_HANDLE)
     {
         cerr << "Animation not found: " << identifier.name << ", " << ToString(identifier.variant) << endl;
+        return;
     }
+
+    SetAnimation(handle);
 }
 
 void AnimationTracker::SetAnimation(AnimationName name, AnimationVariant variant)
@@ -122,7 +265,7 @@ void AnimationTracker::SetAnimation(AnimationName name)
 
 void AnimationTracker::setFrame(unsigned frame)
 {
-    if (spritesheet_data.frames.size() <= frame)
+    if (spritesheet_data->frames.size() <= frame)
     {
         cerr << "Could not set frame: " << frame << endl;
         return;
@@ -157,23 +300,24 @@ AnimationTracker AnimationTracker::ConstructAnimationTracker(EntityType entity_t
 
 AnimationTracker AnimationTracker::ConstructAnimationTracker(std::string filepath)
 {
-    static std::map<std::string, AnimationTracker> animation_data_cache;
+    static std::map<std::string, std::shared_ptr<const SpritesheetData>> animation_data_cache;
 
-    if (animation_data_cache.find(filepath) != animation_data_cache.end())
+    AnimationTracker tracker;
+
+    auto iterator = animation_data_cache.find(filepath);
+    if (iterator != animation_data_cache.end())
     {
-        return animation_data_cache[filepath];
+        tracker.spritesheet_data = iterator->second;
+        return tracker;
     }
 
-    AnimationTracker tracker;
-
     try
     {
-        std::ifstream file(filepath);
-        nlohmann::json j;
-        file >> j;
+        nlohmann::json j = LoadJson(filepath);
 
-        tracker.spritesheet_data.frames = std::vector<Frame>(j["frames"].size());
-        tracker.spritesheet_data.filepath = j["filename"];
+        auto spritesheet = createSpritesheet();
+        spritesheet->frames = std::vector<Frame>(j["frames"].size());
+        spritesheet->filepath = j["filename"];
 
         for (auto& object : j["frames"])
         {
@@ -210,7 +354,7 @@ AnimationTracker AnimationTracker::ConstructAnimationTracker(std::string filepat
             }
 
             frame.index = object["index"];
-            tracker.spritesheet_data.frames[frame.index] = frame;
+            spritesheet->frames[frame.index] = frame;
         }
 
         for (auto& j_animation : j["animations"])
@@ -218,7 +362,7 @@ AnimationTracker AnimationTracker::ConstructAnimationTracker(std::string filepat
             std::string name = j_animation["name"];
             for (auto& j_variant : j_animation["variants"])
             {
-                AnimationData animation;
+                AnimationData animation{};
                 animation.identifier.name = name;
                 animation.identifier.variant = ToVariant(j_variant["name"]);
                 animation.start_frame = j_variant["start_frame"];
@@ -253,16 +397,19 @@ AnimationTracker AnimationTracker::ConstructAnimationTracker(std::string filepat
                     animation.collision_dimensions.y = j_variant["collision_dimensions"]["y"];
                 }
 
-                tracker.spritesheet_data.animations[animation.identifier.name][animation.identifier.variant] = animation;
+                addAnimation(*spritesheet, animation);
             }
         }
 
-        if (tracker.spritesheet_data.animations.empty())
+        if (spritesheet->animations.empty())
         {
             throw std::runtime_error("Spritesheet has no animations: " + filepath + "\n");
         }
 
-        animation_data_cache["filepath"] = tracker;
+        linkAnimations(*spritesheet);
+
+        animation_data_cache[filepath] = spritesheet;
+        tracker.spritesheet_data = spritesheet;
     }
     catch(const std::exception& e)
     {
@@ -9,10 +9,11 @@
 #include "definitions.h"
 #include "game_math.h"
 #include "debug_overrides.h"
+#include "definitions_pack.h"
 #include "nlohmann/json.hpp"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
-#include <fstream>
 #include <random>
 
 using std::cout, std::cerr, std::endl;
@@ -46,9 +47,7 @@ public:
 
             try
             {
-                std::ifstream file(region_file.path());
-                nlohmann::json json;
-                file >> json;
+                nlohmann::json json = LoadJson(region_file.path());
 
                 RegionDefinition region;
                 region.name = json["name"];
@@ -192,18 +191,9 @@ public:
 
             try
             {
-                std::ifstream file(entity_file.path());
-                nlohmann::json json;
-                file >> json;
-
-                EntityDefinition entity;
-                entity.behaviors = { { Behavior::Wandering, false }, { Behavior::Feeding, false },
-                                     { Behavior::Hunting, false }, { Behavior::Stalking, false }, { Behavior::Dead, false } };
-
-                entity.actions = { { Action::Knockback, false }, { Action::Sniffing, false }, { Action::Stunned, false } };
-
-                entity.attacks = { { Action::Tackling, std::nullopt }, { Action::Leaping, std::nullopt }};
+                nlohmann::json json = LoadJson(entity_file.path());
 
+                EntityDefinition entity{};
                 entity.base_health = json["base_health"];
                 entity.base_movement_speed = json["movement_speed"];
                 entity.animation_definition_file = entity_file.path().filename().string();
@@ -232,36 +222,62 @@ public:
                 entity.close_quarters_range = json["close_quarters_range"];
                 entity.leash_range = json["leash_range"];
                 entity.base_aggression = json["base_aggression"];
+                entity.decision_interval = 0;
+                if (json.find("decision_interval") != json.end())
+                {
+                    entity.decision_interval = json["decision_interval"];
+                }
+
+                if (json.find("ai_detail") != json.end())
+                {
+                    auto& j_detail = json["ai_detail"];
+                    if (j_detail.find("reduced") != j_detail.end())
+                    {
+                        entity.ai_detail.reduced_range = j_detail["reduced"]["range"];
+                        entity.ai_detail.reduced_interval = j_detail["reduced"]["interval"];
+                    }
+                    if (j_detail.find("minimal") != j_detail.end())
+                    {
+                        entity.ai_detail.minimal_range = j_detail["minimal"]["range"];
+                        entity.ai_detail.minimal_interval = j_detail["minimal"]["interval"];
+                    }
+
+                    // Players would walk into aggro range of enemies that only look for them a few times a second
+                    if (entity.ai_detail.reduced_range < entity.aggro_range || entity.ai_detail.minimal_range < entity.aggro_range)
+                    {
+                        cerr << "AI detail ranges inside the aggro range in entity file: " << entity_file.path() << "\n";
+                    }
+                }
 
                 for (auto& behavior : json["behaviors"])
                 {
                     if (behavior == "wandering")
                     {
-                        entity.behaviors[Behavior::Wandering] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Wandering));
                     }
                     else if (behavior == "feeding")
                     {
-                        entity.behaviors[Behavior::Feeding] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Feeding));
                     }
                     else if (behavior == "hunting")
                     {
-                        entity.behaviors[Behavior::Hunting] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Hunting));
                     }
                     else if (behavior == "stalking")
                     {
-                        entity.behaviors[Behavior::Stalking] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Stalking));
                     }
                     else if (behavior == "flocking")
                     {
-                        entity.behaviors[Behavior::Flocking] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Flocking));
                     }
                     else if (behavior == "swarming")
                     {
-                        entity.behaviors[Behavior::Swarming] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Swarming));
                     }
                     else if (behavior == "dead")
                     {
-                        entity.behaviors[Behavior::Dead] = true;
+                        entity.behaviors.set(static_cast<size_t>(Behavior::Dead));
                     }
                     else
                     {
@@ -271,7 +287,7 @@ public:
 
                 for (auto& j_attack : json["attacks"])
                 {
-                    AttackDefinition attack_definition;
+                    AttackDefinition attack_definition{};
                     attack_definition.damage = j_attack["damage"];
                     attack_definition.range = j_attack["range"];
                     attack_definition.minimum_range = 0;
@@ -280,7 +296,6 @@ public:
                         attack_definition.minimum_range = j_attack["minimum_range"];
                     }
                     attack_definition.cooldown = j_attack["cooldown"];
-                    attack_definition.cooldown_timer = 0;
                     if (j_attack.find("duration") != j_attack.end())
                     {
                         attack_definition.duration = j_attack["duration"];
@@ -294,15 +309,15 @@ public:
                     std::string name = j_attack["name"];
                     if (name == "tackle")
                     {
-                        entity.attacks[Action::Tackling] = attack_definition;
+                        entity.attacks[static_cast<size_t>(Action::Tackling)] = attack_definition;
                     }
                     else if (name == "leap")
                     {
-                        entity.attacks[Action::Leaping] = attack_definition;
+                        entity.attacks[static_cast<size_t>(Action::Leaping)] = attack_definition;
                     }
                     else if (name == "tail swipe")
                     {
-                        entity.attacks[Action::TailSwipe] = attack_definition;
+                        entity.attacks[static_cast<size_t>(Action::TailSwipe)] = attack_definition;
                     }
                     else
                     {
@@ -314,15 +329,15 @@ public:
                 {
                     if (action == "knockback")
                     {
-                        entity.actions[Action::Knockback] = true;
+                        entity.actions.set(static_cast<size_t>(Action::Knockback));
                     }
                     else if (action == "sniffing")
                     {
-                        entity.actions[Action::Sniffing] = true;
+                        entity.actions.set(static_cast<size_t>(Action::Sniffing));
                     }
                     else if (action == "stunned")
                     {
-                        entity.actions[Action::Stunned] = true;
+                        entity.actions.set(static_cast<size_t>(Action::Stunned));
                     }
                     else
                     {
@@ -333,11 +348,11 @@ public:
                 std::string type = entity_file.path().filename().string().substr(0, entity_file.path().filename().string().find_first_of('.'));
                 if (type == "bat")
                 {
-                    definition_map[EntityType::Bat] = entity;
+                    entity_definitions[static_cast<size_t>(EntityType::Bat)] = entity;
                 }
                 else if (type == "small_demon")
                 {
-                    definition_map[EntityType::SmallDemon] = entity;
+                    entity_definitions[static_cast<size_t>(EntityType::SmallDemon)] = entity;
                 }
             }
             catch (const std::exception& e)
@@ -347,7 +362,7 @@ public:
         }
     }
 
-    std::map<EntityType, EntityDefinition> definition_map;
+    std::array<EntityDefinition, ENTITY_TYPE_COUNT> entity_definitions{};
 };
 
 class PackDatabase
@@ -364,9 +379,7 @@ public:
 
         try
         {
-            std::ifstream file(path);
-            nlohmann::json json;
-            file >> json;
+            nlohmann::json json = LoadJson(path);
 
             for (auto& j_pack : json["packs"])
             {
@@ -421,6 +434,22 @@ public:
         return spawns[difficulty][0];
     }
 
+    std::vector<EnemyPack> GetPacksByDifficulty(PackDifficulty difficulty)
+    {
+        return spawns[difficulty];
+    }
+
+    std::vector<EnemyPack> GetAllPacks()
+    {
+        std::vector<EnemyPack> packs;
+        for (auto& [id, pack] : spawn_map)
+        {
+            packs.push_back(pack);
+        }
+
+        return packs;
+    }
+
     EnemyPack GetPackByName(PackIdentifier id)
     {
         if (spawn_map.find(id) == spawn_map.end())
@@ -436,6 +465,12 @@ private:
     std::array<std::vector<EnemyPack>, 10> spawns;
 };
 
+RegionInitializer& GetRegionInitializer()
+{
+    static RegionInitializer initializer;
+    return initializer;
+}
+
 PackDatabase& GetPackDatabase()
 {
     static PackDatabase database;
@@ -446,12 +481,82 @@ PackDatabase& GetPackDatabase()
 
 RegionDefinition GetRegionDefinition(RegionType region)
 {
-    static RegionInitializer initializer;
+    RegionInitializer& initializer = GetRegionInitializer();
     assert(initializer.Regions.find(region) != initializer.Regions.end());
     assert(initializer.Regions[region].find(0) != initializer.Regions[region].end());
     return initializer.Regions[region][0];
 }
 
+util::RouteTable CreateRouteTable(const Zone& zone)
+{
+    std::vector<util::RouteLink> links;
+    for (auto& link : zone.links)
+    {
+        links.push_back(util::RouteLink{link.start, link.finish, static_cast<float>(link.distance)});
+    }
+
+    return util::CreateRouteTable(Zone::ZONE_WIDTH / 200 * Zone::ZONE_HEIGHT / 200, links);
+}
+
+std::vector<RegionDefinition> GetAllRegionDefinitions()
+{
+    std::vector<RegionDefinition> regions;
+    for (auto& [type, regions_of_type] : GetRegionInitializer().Regions)
+    {
+        for (auto& [id, region] : regions_of_type)
+        {
+            regions.push_back(region);
+        }
+    }
+
+    return regions;
+}
+
+std::vector<EntityType> GetSpawnableEnemyTypes(const RegionDefinition& region)
+{
+    std::vector<EnemyPack> packs = region.enemy_packs;
+    if (region.leyline)
+    {
+        std::vector<EnemyPack> leyline_packs = GetAllEnemyPacks();
+        packs.insert(packs.end(), leyline_packs.begin(), leyline_packs.end());
+    }
+
+    std::vector<EntityType> types;
+    for (auto& pack : packs)
+    {
+        for (auto& spawn : pack.spawns)
+        {
+            types.push_back(spawn.type);
+        }
+    }
+
+    std::sort(types.begin(), types.end());
+    types.erase(std::unique(types.begin(), types.end()), types.end());
+    return types;
+}
+
+std::vector<EntityType> GetSpawnableEnemyTypes()
+{
+    std::vector<EntityType> types;
+    for (auto& region : GetAllRegionDefinitions())
+    {
+        std::vector<EntityType> region_types = GetSpawnableEnemyTypes(region);
+        types.insert(types.end(), region_types.begin(), region_types.end());
+    }
+
+    for (auto& pack : GetAllEnemyPacks())
+    {
+        for (auto& spawn : pack.spawns)
+        {
+            types.push_back(spawn.type);
+        }
+    }
+
+    std::sort(types.begin(), types.end());
+    types.erase(std::unique(types.begin(), types.end()), types.end());
+    return types;
+}
+
 EnemyPack GetEnemyPackByDifficulty(PackDifficulty difficulty)
 {
     return GetPackDatabase().GetPackByDifficulty(difficulty);
@@ -462,11 +567,21 @@ EnemyPack GetEnemyPackById(PackIdentifier id)
     return GetPackDatabase().GetPackByName(id);
 }
 
-EntityDefinition GetEntityDefinition(EntityType type)
+std::vector<EnemyPack> GetEnemyPacksByDifficulty(PackDifficulty difficulty)
+{
+    return GetPackDatabase().GetPacksByDifficulty(difficulty);
+}
+
+std::vector<EnemyPack> GetAllEnemyPacks()
+{
+    return GetPackDatabase().GetAllPacks();
+}
+
+const EntityDefinition& GetEntityDefinition(EntityType type)
 {
     static EntityDefinitionManager manager;
 
-    return manager.definition_map[type];
+    return manager.entity_definitions[static_cast<size_t>(type)];
 }
 
 AnimationVariant ToVariant(std::string variant)
@@ -548,6 +663,118 @@ std::string ToString(AnimationVariant variant)
     return "None";
 }
 
+AnimationType ToAnimationType(AnimationName name)
+{
+    static const std::map<AnimationName, AnimationType> type_map = {
+        { "Rest", AnimationType::Rest },
+        { "Move", AnimationType::Move },
+        { "Feed", AnimationType::Feed },
+        { "Knockback", AnimationType::Knockback },
+        { "Stun", AnimationType::Stun },
+        { "Tackle", AnimationType::Tackle },
+        { "Death", AnimationType::Death },
+        { "Sniff", AnimationType::Sniff },
+        { "LeapWindup", AnimationType::LeapWindup },
+        { "Leap", AnimationType::Leap },
+        { "LeapResting", AnimationType::LeapResting },
+        { "HopWindup", AnimationType::HopWindup },
+        { "Hop", AnimationType::Hop },
+        { "TailSwipe", AnimationType::TailSwipe }
+    };
+
+    auto iterator = type_map.find(name);
+    if (iterator == type_map.end())
+    {
+        return AnimationType::None;
+    }
+
+    return iterator->second;
+}
+
+AnimationName ToString(AnimationType type)
+{
+    switch (type)
+    {
+        case AnimationType::None:
+        {
+            return "None";
+        }
+        break;
+        case AnimationType::Rest:
+        {
+            return "Rest";
+        }
+        break;
+        case AnimationType::Move:
+        {
+            return "Move";
+        }
+        break;
+        case AnimationType::Feed:
+        {
+            return "Feed";
+        }
+        break;
+        case AnimationType::Knockback:
+        {
+            return "Knockback";
+        }
+        break;
+        case AnimationType::Stun:
+        {
+            return "Stun";
+        }
+        break;
+        case AnimationType::Tackle:
+        {
+            return "Tackle";
+        }
+        break;
+        case AnimationType::Death:
+        {
+            return "Death";
+        }
+        break;
+        case AnimationType::Sniff:
+        {
+            return "Sniff";
+        }
+        break;
+        case AnimationType::LeapWindup:
+        {
+            return "LeapWindup";
+        }
+        break;
+        case AnimationType::Leap:
+        {
+            return "Leap";
+        }
+        break;
+        case AnimationType::LeapResting:
+        {
+            return "LeapResting";
+        }
+        break;
+        case AnimationType::HopWindup:
+        {
+            return "HopWindup";
+        }
+        break;
+        case AnimationType::Hop:
+        {
+            return "Hop";
+        }
+        break;
+        case AnimationType::TailSwipe:
+        {
+            return "TailSwipe";
+        }
+        break;
+    }
+
+    return "None";
+}
+
 AnimationVariant GetAnimationVariant(util::Direction direction)
 {
     switch (direction)
@@ -694,6 +921,20 @@ sf::FloatRect ConvoyDefinition::GetInteriorBounds()
     return adjusted_interior;
 }
 
+std::vector<sf::FloatRect> RegionDefinition::GetCollisions()
+{
+    std::vector<sf::FloatRect> region_collisions;
+    for (auto& obstacle : obstacles)
+    {
+        region_collisions.push_back(obstacle.bounds);
+    }
+
+    auto convoy_collisions = convoy.GetCollisions();
+    region_collisions.insert(region_collisions.end(), convoy_collisions.begin(), convoy_collisions.end());
+
+    return region_collisions;
+}
+
 std::vector<sf::FloatRect> ConvoyDefinition::GetCollisions()
 {
     sf::Vector2f relative_position{Position.x - origin.x, Position.y - origin.y};
@@ -729,9 +970,7 @@ void ConvoyDefinition::load(Orientation orientation)
 
     try
     {
-        std::ifstream file(path);
-        nlohmann::json json;
-        file >> json;
+        nlohmann::json json = LoadJson(path);
 
         Width = 0;
         Height = 0;
@@ -786,9 +1025,7 @@ public:
 
         try
         {
-            std::ifstream file(path);
-            nlohmann::json json;
-            file >> json;
+            nlohmann::json json = LoadJson(path);
 
             for (auto& j_event : json["events"])
             {
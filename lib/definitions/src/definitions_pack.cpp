@@ -0,0 +1,339 @@
+/**************************************************************************************************
+ *  File:       definitions_pack.cpp
+ *
+ *  Purpose:    Every JSON definition and spritesheet compiled into one binary pack, memory mapped at
+ *              startup instead of parsing each file
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "definitions_pack.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::cerr, std::endl;
+
+namespace definitions
+{
+
+namespace {
+
+// Bump whenever the pack layout changes
+constexpr uint32_t DEFINITIONS_PACK_VERSION = 1;
+constexpr char DEFINITIONS_PACK_MAGIC[4] = {'S', 'D', 'D', 'P'};
+const std::filesystem::path DEFINITIONS_PACK_PATH = "../data/definitions.pack";
+const std::filesystem::path PACK_SOURCES[] = { "../data/definitions", "../data/sprites" };
+
+// The pack is the header, an entry per file, every file's path, then every file's MessagePack, each entry pointing
+// into the last two by offsets from the start of the pack
+struct PackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t size;
+};
+
+struct PackEntry
+{
+    uint32_t path_offset;
+    uint32_t path_size;
+    uint32_t data_offset;
+    uint32_t data_size;
+    uint64_t source_size; // The file the entry was compiled from, as it was then
+    int64_t source_modified;
+};
+
+static_assert(sizeof(PackHeader) == 24);
+static_assert(sizeof(PackEntry) == 32);
+
+// Paths are compared in one spelling, however the caller built them
+std::string packKey(const std::filesystem::path& path)
+{
+    return path.lexically_normal().generic_string();
+}
+
+// Returns false if the file can't be read
+bool getSourceStamp(const std::filesystem::path& path, uint64_t& out_size, int64_t& out_modified)
+{
+    std::error_code error;
+    out_size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return false;
+    }
+
+    out_modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    return !error;
+}
+
+std::vector<std::filesystem::path> findSources()
+{
+    std::vector<std::pair<std::string, std::filesystem::path>> keyed_sources;
+    for (auto& root : PACK_SOURCES)
+    {
+        if (!std::filesystem::exists(root))
+        {
+            continue;
+        }
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".json")
+            {
+                keyed_sources.emplace_back(packKey(entry.path()), entry.path());
+            }
+        }
+    }
+
+    // Directory order isn't specified, and the pack should only change when its files do
+    std::sort(keyed_sources.begin(), keyed_sources.end(), [](auto& a, auto& b) { return a.first < b.first; });
+
+    std::vector<std::filesystem::path> sources;
+    sources.reserve(keyed_sources.size());
+    for (auto& [key, path] : keyed_sources)
+    {
+        sources.push_back(std::move(path));
+    }
+
+    return sources;
+}
+
+nlohmann::json parseFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    nlohmann::json json;
+    file >> json;
+
+    return json;
+}
+
+bool writePack(const std::vector<std::filesystem::path>& sources)
+{
+    std::vector<PackEntry> entries(sources.size());
+    std::string paths;
+    std::vector<uint8_t> data;
+
+    uint32_t paths_offset = sizeof(PackHeader) + sources.size() * sizeof(PackEntry);
+    for (unsigned i = 0; i < sources.size(); ++i)
+    {
+        // Stamped before reading, so an edit made while the pack is built leaves the entry stale rather than wrong
+        std::vector<uint8_t> encoded;
+        try
+        {
+            if (!getSourceStamp(sources[i], entries[i].source_size, entries[i].source_modified))
+            {
+                throw std::runtime_error("could not read file");
+            }
+
+            encoded = nlohmann::json::to_msgpack(parseFile(sources[i]));
+        }
+        catch(const std::exception& e)
+        {
+            cerr << "Definitions pack not built, failed to parse " << sources[i] << ": " << e.what() << endl;
+            return false;
+        }
+
+        std::string key = packKey(sources[i]);
+        entries[i].path_offset = paths_offset + paths.size();
+        entries[i].path_size = key.size();
+        entries[i].data_offset = data.size(); // Made absolute once the size of every path is known
+        entries[i].data_size = encoded.size();
+
+        paths += key;
+        data.insert(data.end(), encoded.begin(), encoded.end());
+    }
+
+    uint32_t data_offset = paths_offset + paths.size();
+    for (auto& entry : entries)
+    {
+        entry.data_offset += data_offset;
+    }
+
+    PackHeader header{};
+    std::memcpy(header.magic, DEFINITIONS_PACK_MAGIC, sizeof(header.magic));
+    header.version = DEFINITIONS_PACK_VERSION;
+    header.entry_count = entries.size();
+    header.size = data_offset + data.size();
+
+    // Written aside and moved into place, so a client and server starting together never map half a pack
+    std::filesystem::path temporary_path = DEFINITIONS_PACK_PATH;
+    temporary_path += "." + std::to_string(std::random_device{}()) + ".tmp";
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            cerr << "Could not write definitions pack: " << temporary_path << endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+        file.write(paths.data(), paths.size());
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+        if (!file)
+        {
+            cerr << "Could not write definitions pack: " << temporary_path << endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, DEFINITIONS_PACK_PATH, error);
+    if (error)
+    {
+        cerr << "Could not replace definitions pack: " << error.message() << endl;
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+
+    return true;
+}
+
+class DefinitionsPack
+{
+public:
+    DefinitionsPack()
+    {
+        if (!open())
+        {
+            // First run, or a pack from another version
+            std::vector<std::filesystem::path> sources = findSources();
+            if (!sources.empty() && writePack(sources))
+            {
+                open();
+            }
+        }
+    }
+
+    // Returns false if the pack doesn't hold the file as it is now. Files are checked as they're loaded, so startup
+    // never walks the data directories. A stale pack is left for pack_definitions to rebuild, since every process
+    // that loads definitions would otherwise race to rewrite it
+    bool Find(const std::filesystem::path& path, const uint8_t*& out_data, std::size_t& out_size) const
+    {
+        if (!file.IsOpen())
+        {
+            return false;
+        }
+
+        auto iterator = entries.find(packKey(path));
+        if (iterator == entries.end())
+        {
+            warnStale(path);
+            return false;
+        }
+
+        uint64_t source_size;
+        int64_t source_modified;
+        const PackEntry& entry = iterator->second;
+        if (!getSourceStamp(path, source_size, source_modified) || source_size != entry.source_size || source_modified != entry.source_modified)
+        {
+            warnStale(path);
+            return false;
+        }
+
+        out_data = file.Data() + entry.data_offset;
+        out_size = entry.data_size;
+        return true;
+    }
+
+private:
+    void warnStale(const std::filesystem::path& path) const
+    {
+        if (!warned.exchange(true))
+        {
+            cerr << "Definitions pack is out of date for " << path << ", parsing the JSON instead. Run pack_definitions to rebuild it." << endl;
+        }
+    }
+
+    // Keeps the mapping only if the pack is usable, since a mapped file can't be replaced on Windows
+    bool open()
+    {
+        util::MappedFile pack(DEFINITIONS_PACK_PATH);
+        if (!pack.IsOpen() || pack.Size() < sizeof(PackHeader))
+        {
+            return false;
+        }
+
+        PackHeader header;
+        std::memcpy(&header, pack.Data(), sizeof(header));
+
+        if (std::memcmp(header.magic, DEFINITIONS_PACK_MAGIC, sizeof(header.magic)) != 0 || header.version != DEFINITIONS_PACK_VERSION)
+        {
+            return false;
+        }
+
+        if (pack.Size() != header.size || pack.Size() < sizeof(PackHeader) + header.entry_count * sizeof(PackEntry))
+        {
+            cerr << "Definitions pack is truncated: " << DEFINITIONS_PACK_PATH << endl;
+            return false;
+        }
+
+        std::map<std::string, PackEntry> pack_entries;
+        for (uint32_t i = 0; i < header.entry_count; ++i)
+        {
+            PackEntry entry;
+            std::memcpy(&entry, pack.Data() + sizeof(PackHeader) + i * sizeof(PackEntry), sizeof(entry));
+
+            if (static_cast<uint64_t>(entry.path_offset) + entry.path_size > pack.Size() || static_cast<uint64_t>(entry.data_offset) + entry.data_size > pack.Size())
+            {
+                cerr << "Definitions pack is corrupt: " << DEFINITIONS_PACK_PATH << endl;
+                return false;
+            }
+
+            std::string key(reinterpret_cast<const char*>(pack.Data()) + entry.path_offset, entry.path_size);
+            pack_entries[key] = entry;
+        }
+
+        file = std::move(pack);
+        entries = std::move(pack_entries);
+        return true;
+    }
+
+    util::MappedFile file;
+    std::map<std::string, PackEntry> entries;
+    mutable std::atomic<bool> warned = false; // Set from loads, which may come from more than one thread
+};
+
+const DefinitionsPack& getPack()
+{
+    static DefinitionsPack pack;
+    return pack;
+}
+
+} // anonymous namespace
+
+std::filesystem::path GetDefinitionsPackPath()
+{
+    return DEFINITIONS_PACK_PATH;
+}
+
+bool BuildDefinitionsPack()
+{
+    return writePack(findSources());
+}
+
+nlohmann::json LoadJson(const std::filesystem::path& path)
+{
+    const uint8_t* data;
+    std::size_t size;
+    if (getPack().Find(path, data, size))
+    {
+        return nlohmann::json::from_msgpack(data, data + size);
+    }
+
+    return parseFile(path);
+}
+
+} // definitions
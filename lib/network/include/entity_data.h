@@ -33,9 +33,11 @@ struct PlayerProperties
     definitions::WeaponType weapon_type;
 };
 
+constexpr uint16_t UNASSIGNED_PLAYER_ID = 0; // Never handed out, so a player that hasn't been given an id yet is known
+
 struct PlayerData
 {
-    uint16_t id;
+    uint16_t id = UNASSIGNED_PLAYER_ID;
     std::string name;
     sf::Vector2f position;
     uint8_t health;
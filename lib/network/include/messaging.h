@@ -123,6 +123,9 @@ public:
         // Debugging messages
         DisplayPath,
 
+        // Added after the codes above were in use, so that none of them changes value
+        RemoveEnemy,
+
         Error = 0xFF
     };
 
@@ -139,11 +142,12 @@ public:
     static bool SetZone(sf::TcpSocket& socket, definitions::Zone zone);
     static bool SetGuiPause(sf::TcpSocket& socket, bool paused, GuiType gui_type);
     static bool PlayerStartAction(sf::TcpSocket& socket, uint16_t player_id, PlayerAction action);
-    static bool ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationName name);
-    static bool ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationName name, util::Direction direction);
+    static bool ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationType animation);
+    static bool ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationType animation, util::Direction direction);
     static bool ChangeItem(sf::TcpSocket& socket, definitions::ItemType item);
     static bool PlayerStates(sf::TcpSocket& socket, std::vector<PlayerData> players);
     static bool AddEnemy(sf::TcpSocket& socket, uint16_t enemy_id, definitions::EntityType type);
+    static bool RemoveEnemy(sf::TcpSocket& socket, uint16_t enemy_id);
     static bool EnemyUpdate(sf::TcpSocket& socket, std::vector<EnemyData> enemies);
     static bool BatteryUpdate(sf::TcpSocket& socket, float battery_level);
     static bool ProjectileUpdate(sf::TcpSocket& socket, std::vector<ProjectileData> projectiles);
@@ -153,7 +157,7 @@ public:
     static bool CastVote(sf::TcpSocket& socket, uint16_t player_id, uint8_t vote, bool confirm);
     static bool SetMenuEvent(sf::TcpSocket& socket, uint16_t event_id);
     static bool AdvanceMenuEvent(sf::TcpSocket& socket, uint16_t advance_value, bool finish);
-    static bool DisplayPath(sf::TcpSocket& socket, util::PathingGraph graph, std::list<sf::Vector2f> path);
+    static bool DisplayPath(sf::TcpSocket& socket, const util::PathingGraph& graph, const std::vector<sf::Vector2f>& path);
 
     static bool DecodePlayerId(sf::TcpSocket& socket, uint16_t& out_id);
     static bool DecodePlayerJoined(sf::TcpSocket& socket, PlayerData& out_player);
@@ -168,6 +172,7 @@ public:
     static bool DecodeChangeItem(sf::TcpSocket& socket, definitions::ItemType& out_item);
     static bool DecodePlayerStates(sf::TcpSocket& socket, std::vector<PlayerData>& out_players);
     static bool DecodeAddEnemy(sf::TcpSocket& socket, uint16_t& out_enemy_id, definitions::EntityType& out_type);
+    static bool DecodeRemoveEnemy(sf::TcpSocket& socket, uint16_t& out_enemy_id);
     static bool DecodeEnemyUpdate(sf::TcpSocket& socket, std::vector<EnemyData>& out_enemies);
     static bool DecodeBatteryUpdate(sf::TcpSocket& socket, float& out_battery_level);
     static bool DecodeProjectileUpdate(sf::TcpSocket& socket, std::vector<ProjectileData>& out_projectiles);
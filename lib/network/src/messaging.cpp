@@ -118,159 +118,6 @@ bool readString(sf::TcpSocket& socket, std::string& out_string)
     return true;
 }
 
-enum class SerializedAnimation
-{
-    None, Rest, Move, Feed, Knockback, Stun, Tackle, Death,
-    Sniff, LeapWindup, Leap, LeapResting, HopWindup, Hop, TailSwipe
-};
-
-SerializedAnimation getSerializedAnimation(std::string name)
-{
-    if (name == "Rest")
-    {
-        return SerializedAnimation::Rest;
-    }
-    else if (name == "Move")
-    {
-        return SerializedAnimation::Move;
-    }
-    else if (name == "Feed")
-    {
-        return SerializedAnimation::Feed;
-    }
-    else if (name == "Knockback")
-    {
-        return SerializedAnimation::Knockback;
-    }
-    else if (name == "Stun")
-    {
-        return SerializedAnimation::Stun;
-    }
-    else if (name == "Tackle")
-    {
-        return SerializedAnimation::Tackle;
-    }
-    else if (name == "Death")
-    {
-        return SerializedAnimation::Death;
-    }
-    else if (name == "Sniff")
-    {
-        return SerializedAnimation::Sniff;
-    }
-    else if (name == "LeapWindup")
-    {
-        return SerializedAnimation::LeapWindup;
-    }
-    else if (name == "Leap")
-    {
-        return SerializedAnimation::Leap;
-    }
-    else if (name == "LeapResting")
-    {
-        return SerializedAnimation::LeapResting;
-    }
-    else if (name == "HopWindup")
-    {
-        return SerializedAnimation::HopWindup;
-    }
-    else if (name == "Hop")
-    {
-        return SerializedAnimation::Hop;
-    }
-    else if (name == "TailSwipe")
-    {
-        return SerializedAnimation::TailSwipe;
-    }
-
-    cerr << "Animation name not found for serialization: " << name << "\n";
-    return SerializedAnimation::None;
-}
-
-definitions::AnimationName getAnimationName(SerializedAnimation type)
-{
-    switch (type)
-    {
-        case SerializedAnimation::None:
-        {
-            return "None";
-        }
-        break;
-        case SerializedAnimation::Rest:
-        {
-            return "Rest";
-        }
-        break;
-        case SerializedAnimation::Move:
-        {
-            return "Move";
-        }
-        break;
-        case SerializedAnimation::Feed:
-        {
-            return "Feed";
-        }
-        break;
-        case SerializedAnimation::Knockback:
-        {
-            return "Knockback";
-        }
-        break;
-        case SerializedAnimation::Stun:
-        {
-            return "Stun";
-        }
-        break;
-        case SerializedAnimation::Tackle:
-        {
-            return "Tackle";
-        }
-        break;
-        case SerializedAnimation::Death:
-        {
-            return "Death";
-        }
-        break;
-        case SerializedAnimation::Sniff:
-        {
-            return "Sniff";
-        }
-        break;
-        case SerializedAnimation::LeapWindup:
-        {
-            return "LeapWindup";
-        }
-        break;
-        case SerializedAnimation::Leap:
-        {
-            return "Leap";
-        }
-        break;
-        case SerializedAnimation::LeapResting:
-        {
-            return "LeapResting";
-        }
-        break;
-        case SerializedAnimation::HopWindup:
-        {
-            return "HopWindup";
-        }
-        break;
-        case SerializedAnimation::Hop:
-        {
-            return "Hop";
-        }
-        break;
-        case SerializedAnimation::TailSwipe:
-        {
-            return "TailSwipe";
-        }
-        break;
-    }
-
-    return "None";
-}
-
 } // anonymous namespace
 
 // ====================================================== Client Message ======================================================
@@ -1044,17 +891,15 @@ bool ServerMessage::PlayerStartAction(sf::TcpSocket& socket, uint16_t player_id,
     return true;
 }
 
-bool ServerMessage::ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationName name)
+bool ServerMessage::ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationType animation)
 {
-    return ChangeEnemyAnimation(socket, enemy_id, name, util::Direction::None);
+    return ChangeEnemyAnimation(socket, enemy_id, animation, util::Direction::None);
 }
 
-bool ServerMessage::ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationName name, util::Direction direction)
+bool ServerMessage::ChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t enemy_id, definitions::AnimationType animation, util::Direction direction)
 {
     Code code = ServerMessage::Code::ChangeEnemyAnimation;
 
-    SerializedAnimation animation = getSerializedAnimation(name);
-
     constexpr size_t buffer_size = sizeof(code) + sizeof(enemy_id) + sizeof(animation) + sizeof(direction);
     uint8_t buffer[buffer_size];
 
@@ -1123,6 +968,25 @@ bool ServerMessage::AddEnemy(sf::TcpSocket& socket, uint16_t enemy_id, definitio
     return true;
 }
 
+bool ServerMessage::RemoveEnemy(sf::TcpSocket& socket, uint16_t enemy_id)
+{
+    Code code = ServerMessage::Code::RemoveEnemy;
+
+    constexpr size_t buffer_size = sizeof(code) + sizeof(enemy_id);
+    uint8_t buffer[buffer_size];
+
+    std::memcpy(buffer, &code, sizeof(code));
+    std::memcpy(buffer + sizeof(code), &enemy_id, sizeof(enemy_id));
+
+    if (!writeBuffer(socket, buffer, buffer_size))
+    {
+        cerr << "Network: Failed to send ServerMessage::" << __func__ << " message" << endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool ServerMessage::EnemyUpdate(sf::TcpSocket& socket, std::vector<EnemyData> enemies)
 {
     Code code = ServerMessage::Code::EnemyUpdate;
@@ -1357,7 +1221,7 @@ bool ServerMessage::AdvanceMenuEvent(sf::TcpSocket& socket, uint16_t page_id, bo
     return true;
 }
 
-bool ServerMessage::DisplayPath(sf::TcpSocket& socket, util::PathingGraph graph, std::list<sf::Vector2f> path)
+bool ServerMessage::DisplayPath(sf::TcpSocket& socket, const util::PathingGraph& graph, const std::vector<sf::Vector2f>& path)
 {
     Code code = ServerMessage::Code::DisplayPath;
 
@@ -1375,7 +1239,7 @@ bool ServerMessage::DisplayPath(sf::TcpSocket& socket, util::PathingGraph graph,
     offset += sizeof(num_graph_nodes);
     for (unsigned i = 0; i < num_graph_nodes; ++i)
     {
-        sf::Vector2f node = graph.nodes[i].position;
+        sf::Vector2f node = graph.nodes[i];
         std::memcpy(buffer + offset, &node, sizeof(node));
         offset += sizeof(node);
     }
@@ -1683,7 +1547,7 @@ bool ServerMessage::DecodePlayerStartAction(sf::TcpSocket& socket, uint16_t& out
 bool ServerMessage::DecodeChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t& out_enemy_id, definitions::AnimationName& out_name, util::Direction& out_direction)
 {
     uint16_t id;
-    SerializedAnimation animation;
+    definitions::AnimationType animation;
     util::Direction direction;
 
     if (!read(socket, &id, sizeof(id)))
@@ -1704,10 +1568,8 @@ bool ServerMessage::DecodeChangeEnemyAnimation(sf::TcpSocket& socket, uint16_t&
         return false;
     }
 
-    definitions::AnimationName name = getAnimationName(animation);
-
     out_enemy_id = id;
-    out_name = name;
+    out_name = definitions::ToString(animation);
     out_direction = direction;
 
     return true;
@@ -1749,6 +1611,19 @@ bool ServerMessage::DecodeAddEnemy(sf::TcpSocket& socket, uint16_t& out_enemy_id
     return true;
 }
 
+bool ServerMessage::DecodeRemoveEnemy(sf::TcpSocket& socket, uint16_t& out_enemy_id)
+{
+    uint16_t enemy_id;
+    if (!read(socket, &enemy_id, sizeof(enemy_id)))
+    {
+        cerr << "Network: " << __func__ << " failed to read enemy id." << endl;
+        return false;
+    }
+
+    out_enemy_id = enemy_id;
+    return true;
+}
+
 bool ServerMessage::DecodeEnemyUpdate(sf::TcpSocket& socket, std::vector<EnemyData>& out_enemies)
 {
     uint16_t num_enemies;
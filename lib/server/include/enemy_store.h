@@ -0,0 +1,66 @@
+/**************************************************************************************************
+ *  File:       enemy_store.h
+ *  Class:      EnemyStore
+ *
+ *  Purpose:    The state every enemy touches each tick, kept in one array per field
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "definitions.h"
+#include "entity_data.h"
+#include "game_math.h"
+#include "slot_map.h"
+#include <cstdint>
+#include <vector>
+#include "SFML/Graphics/Rect.hpp"
+#include "SFML/System/Vector2.hpp"
+
+namespace server
+{
+
+// Enemy i's state is at index i of every array. Indices are dense, so removing an enemy moves the last one into its
+// place; an enemy's id stays the same for its lifetime and IndexOf maps it back to its current index in constant time
+class EnemyStore
+{
+public:
+    static constexpr unsigned INVALID_INDEX = util::SLOT_NOT_FOUND;
+
+    void Reserve(unsigned capacity);
+    unsigned Add(uint16_t id, definitions::EntityType type, sf::Vector2f position);
+    void Remove(unsigned index);
+    unsigned IndexOf(uint16_t id) const;
+    unsigned IndexOf(util::SlotHandle handle) const; // INVALID_INDEX once the enemy is gone
+    util::SlotHandle GetHandle(uint16_t id) const;
+    unsigned Size() const;
+
+    network::EnemyData GetData(unsigned index) const;
+    sf::FloatRect GetBounds(unsigned index) const;
+    void AdvanceTimers(util::Seconds elapsed);
+
+    static float GetPhase(uint16_t id); // Spread over [0, 1) by id, to offset the schedules of enemies spawned together
+
+    std::vector<uint16_t> Ids;
+    std::vector<definitions::EntityType> Types;
+    std::vector<sf::Vector2f> Positions;
+    std::vector<sf::Vector2f> Velocities;
+    std::vector<float> Speeds;
+    std::vector<float> MaxSpeeds;
+    std::vector<uint8_t> Health;
+    std::vector<definitions::Behavior> Behaviors;
+    std::vector<definitions::Action> Actions;
+    std::vector<sf::Vector2f> Sizes; // Collision dimensions of the current animation
+    std::vector<util::Seconds> ReplanTimers;
+    std::vector<util::Seconds> HoppingCooldowns;
+    std::vector<definitions::AiDetail> Details;
+    std::vector<util::Seconds> DeferredTime; // Elapsed time not yet simulated, for enemies below full detail
+    std::vector<util::Seconds> DetailCountdowns; // Until the next update of an enemy below full detail
+    std::vector<util::Seconds> DecisionCountdowns; // Until the enemy next chooses a behavior or target
+
+private:
+    util::SlotMap id_slots;
+};
+
+} // server
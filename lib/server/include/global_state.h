@@ -8,10 +8,12 @@
  *************************************************************************************************/
 #pragma once
 #include "player.h"
+#include "slot_map.h"
 
 namespace server::global
 {
     extern std::vector<Player> PlayerList;
+    extern util::SlotMap PlayerSlots; // Player id to index in PlayerList, for players that have been given an id
     extern bool Paused;
     extern bool GatheringPlayers;
     extern bool RegionSelect;
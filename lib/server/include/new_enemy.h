@@ -11,24 +11,30 @@
 
 #include "animation_tracker.h"
 #include "definitions.h"
+#include "enemy_store.h"
 #include "messaging.h"
 #include "game_math.h"
+#include "invulnerability_table.h"
+#include "slot_map.h"
+#include <array>
 #include <optional>
 
-using definitions::Behavior, definitions::Action;
+using definitions::Behavior, definitions::Action, definitions::AnimationType;
 
 namespace server {
 
-// forward declaration
+// forward declarations
 class Region;
+class Player;
 
 class Enemy
 {
 public:
-    Enemy(Region* region_ptr, definitions::EntityType enemy_type, sf::Vector2f position);
-    Enemy(Region* region_ptr, definitions::EntityType enemy_type, sf::Vector2f position, sf::Vector2f pack_spawn);
+    Enemy(Region* region_ptr, uint16_t enemy_id, definitions::EntityType enemy_type, sf::Vector2f position);
+    Enemy(Region* region_ptr, uint16_t enemy_id, definitions::EntityType enemy_type, sf::Vector2f position, sf::Vector2f pack_spawn);
 
     void Update(sf::Time elapsed);
+    void Decide();
     void WeaponHit(uint16_t player_id, uint8_t damage, definitions::WeaponKnockback knockback, sf::Vector2f hit_vector, float invulnerability_window);
 
     network::EnemyData GetData();
@@ -38,8 +44,9 @@ public:
     const sf::FloatRect GetBounds(sf::Vector2f position);
     const sf::Vector2f GetPathingSize();
     int GetSiphonRate();
+    void SetStoreIndex(unsigned index); // For when the region compacts its enemies
 
-    bool Despawn = false;
+    bool Despawn = false; // Set once the corpse has lingered long enough for the region to remove it
 
 private:
     void setBehavior(Behavior behavior);
@@ -63,10 +70,11 @@ private:
     void handleHopping(sf::Time elapsed);
     void handleTailSwipe(sf::Time elapsed);
 
-    void changeAnimation(definitions::AnimationName animation_name);
-    void changeAnimation(definitions::AnimationName animation_name, util::Direction direction);
+    void changeAnimation(definitions::AnimationType animation);
+    void changeAnimation(definitions::AnimationType animation, util::Direction direction);
     std::optional<uint16_t> playerInRange(float aggro_distance);
     bool aggroPlayer();
+    const Player* getTarget();
     sf::Vector2f getTargetConvoyPoint();
     float getConvoyDistance();
 
@@ -76,36 +84,68 @@ private:
     bool takeStep(sf::Vector2f step);
     bool checkStuck(sf::Time elapsed);
     sf::Vector2f getGoal();
+    bool shouldReplan();
+    void replan();
+    void receivePath();
     sf::Vector2f steer(sf::Vector2f goal);
     void accelerate(sf::Time elapsed);
     void decelerate(sf::Time elapsed);
     sf::Vector2f getRepulsionForce(float distance);
 
+    // State touched every tick lives in the region's EnemyStore, at this enemy's index
+    uint16_t id() { return store->Ids[store_index]; }
+    definitions::EntityType type() { return store->Types[store_index]; }
+    sf::Vector2f& position() { return store->Positions[store_index]; }
+    sf::Vector2f& velocity() { return store->Velocities[store_index]; }
+    float& speed() { return store->Speeds[store_index]; }
+    float& maxSpeed() { return store->MaxSpeeds[store_index]; }
+    uint8_t& health() { return store->Health[store_index]; }
+    Behavior behavior() { return store->Behaviors[store_index]; }
+    Action action() { return store->Actions[store_index]; }
+    util::Seconds& replanTimer() { return store->ReplanTimers[store_index]; }
+    util::Seconds& hoppingCooldown() { return store->HoppingCooldowns[store_index]; }
+    definitions::AiDetail detail() { return store->Details[store_index]; }
+
     Region* region = nullptr;
-    definitions::EntityDefinition definition;
-    network::EnemyData data{};
+    EnemyStore* store = nullptr;
+    unsigned store_index = 0;
+    const definitions::EntityDefinition* definition = nullptr; // Shared by every enemy of the type
+    std::array<util::Seconds, definitions::ACTION_COUNT> attack_cooldowns{}; // Since each attack was last used, by its action
 
     Behavior previous_behavior = Behavior::None;
     Action previous_action = Action::None;
-    Behavior current_behavior = Behavior::None;
-    Action current_action = Action::None;
 
     definitions::AnimationTracker animation_tracker;
     util::Seconds animation_time;
+    util::Seconds corpse_timer = 0;
     sf::Vector2f spawn_position;
     sf::Vector2f destination;
+    std::vector<unsigned> obstacle_candidates;
+    std::vector<Enemy*> neighbors;
+
+    // Destinations shared with other enemies are followed through the region's flow fields instead of a path search
+    enum class GoalField
+    {
+        None,
+        Convoy,
+        Player
+    };
+
+    GoalField goal_field = GoalField::None;
+    std::vector<sf::Vector2f> waypoints;
+    unsigned next_waypoint = 0;
+    sf::Vector2f path_destination;
+    sf::Vector2f requested_destination;
+    bool path_planned = false;
+    bool path_pending = false;
     bool is_moving = false;
     bool is_walking = false;
     bool braking = false;
-    sf::Vector2f current_velocity{0, 0};
-    float current_speed = 0;
-    float current_max_speed = 0;
     int aggro_range;
-    uint16_t aggro_target;
+    util::SlotHandle aggro_target;
     util::DistanceUnits combat_range;
 
-    std::map<uint16_t, util::Seconds> invulnerability_timers;
-    std::map<uint16_t, float> invulnerability_windows;
+    util::InvulnerabilityTable invulnerability; // By player id
 
     enum class WanderState
     {
@@ -149,7 +189,6 @@ private:
     StalkingState stalking_state = StalkingState::Start;
     util::Seconds stalking_timer = 0;
     util::Seconds stalking_rest_time;
-    util::Seconds hopping_cooldown_timer = 0;
 
     enum class FlockingState
     {
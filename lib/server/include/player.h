@@ -15,6 +15,7 @@
 #include <queue>
 #include "entity_data.h"
 #include "game_math.h"
+#include "invulnerability_table.h"
 #include "region.h"
 #include "definitions.h"
 
@@ -50,10 +51,11 @@ public:
     definitions::Weapon GetWeapon();
     void SetWeapon(definitions::Weapon new_weapon);
     void Damage(int damage_value);
-    bool SpawnProjectile(definitions::Projectile& out_projectile);
+    bool SpawnProjectile(definitions::Projectile& out_projectile); // The region gives the projectile its id
     definitions::ItemType UseItem();
     definitions::ItemType ChangeItem(definitions::ItemType item);
     void AddIncomingAttack(definitions::AttackEvent attack);
+    void ClearInvulnerability(); // For when the players move to a new region, whose clock starts over
 
     std::shared_ptr<sf::TcpSocket> Socket;
     PlayerStatus Status;
@@ -68,7 +70,7 @@ private:
     void handleAttack(sf::Time elapsed, Region& region);
     void step(sf::Time elapsed, Region& region);
     void takeStep(sf::Vector2f step, Region& region);
-    void processIncomingAttacks();
+    void processIncomingAttacks(util::Seconds now);
     void startPlayerAction(network::PlayerAction action);
 
     definitions::PlayerDefinition definition;
@@ -85,9 +87,11 @@ private:
     util::AngleDegrees starting_attack_angle;
     util::AngleDegrees current_attack_angle;
     util::Seconds attack_timer = 0;
+    std::vector<unsigned> obstacle_candidates;
+    util::RectBatch enemy_bounds; // Rebuilt for every sword swing, so the sword is tested against every enemy in one batch
+    std::vector<uint8_t> enemy_hits;
 
-    std::map<uint16_t, util::Seconds> invulnerability_timers;
-    std::map<uint16_t, float> invulnerability_windows;
+    util::InvulnerabilityTable invulnerability; // By enemy id, against the region's age
 
     std::queue<definitions::AttackEvent> attack_events;
 };
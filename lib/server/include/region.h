@@ -10,46 +10,157 @@
 #pragma once
 
 #include "game_math.h"
+#include "enemy_store.h"
 #include "new_enemy.h"
-#include <list>
+#include "pathfinding.h"
+#include "flow_field.h"
+#include "id_allocator.h"
+#include "region_events.h"
+#include "spatial_hash.h"
+#include <array>
+#include <deque>
 #include <random>
 #include "SFML/System/Clock.hpp"
 
 namespace server
 {
 
+// The passes Region::Update makes, in the order it makes them
+enum class RegionPhase
+{
+    FlowFields, PathRequests, Despawn, EnemyIndex, DetailLevels, Enemies, Projectiles, Battery, Spawning
+};
+
+constexpr size_t REGION_PHASE_COUNT = static_cast<size_t>(RegionPhase::Spawning) + 1;
+
+struct RegionMetrics
+{
+    unsigned replans = 0; // Path searches completed in the current window
+    float replans_per_second = 0; // Rate over the last completed window
+    unsigned queued_paths = 0; // Path requests still waiting at the end of the last tick
+    unsigned path_work = 0; // Node expansions and visibility tests spent by the path queue in the last tick
+    unsigned enemy_updates = 0; // Enemies updated in the last tick, fewer than there are when some are below full detail
+    unsigned decisions = 0; // Enemies that chose a behavior or target in the last tick
+    int64_t decision_time = 0; // Microseconds those decisions took
+    std::array<int64_t, REGION_PHASE_COUNT> phase_times{}; // Microseconds each phase of the last tick took
+};
+
 class Region
 {
 public:
     Region();
     Region(definitions::RegionType region_name, int player_count, float battery_level);
+    Region(definitions::RegionType region_name, int player_count, float battery_level, RegionEventSink& events);
 
     void Update(sf::Time elapsed);
     bool AdvanceMenuEvent(uint16_t winner, uint16_t& out_event_id, uint16_t& out_event_action);
 
+    sf::FloatRect GetFeedingZone();
+    const util::FlowGrid& GetFlowGrid(definitions::EntityType type);
+    const util::FlowField& GetConvoyFlowField(definitions::EntityType type);
+    const util::FlowField& GetPlayerFlowField(definitions::EntityType type, uint16_t player_id);
+    void RequestPath(uint16_t enemy_id, definitions::EntityType type, sf::Vector2f start, sf::Vector2f finish, sf::FloatRect entity_bounds);
+    bool TakePath(uint16_t enemy_id, std::vector<sf::Vector2f>& out_path);
+    const util::PathingGraph& GetPathingGraph(definitions::EntityType type);
+    void QueryEnemies(sf::FloatRect area, std::vector<Enemy*>& out_enemies);
+    Enemy& GetEnemy(uint16_t enemy_id);
+    void AddProjectile(definitions::Projectile projectile);
+    unsigned SpawnHorde(unsigned enemy_count, definitions::PackDifficulty difficulty); // Returns how many were spawned
+    RegionEventSink& GetEventSink();
+    util::Seconds GetAge(); // The clock invulnerability windows expire against
+
     sf::FloatRect Bounds;
     definitions::ConvoyDefinition Convoy{};
-    std::list<Enemy> Enemies;
+    std::vector<Enemy> Enemies; // In the same order as EnemyStates
+    EnemyStore EnemyStates;
     std::vector<sf::FloatRect> Obstacles;
-    std::list<definitions::Projectile> Projectiles;
+    util::ObstacleGrid ObstacleIndex;
+    std::vector<definitions::Projectile> Projectiles; // Unordered, so removal can swap in the last projectile
     float BatteryLevel = 0;
     bool Leyline = false;
 
     std::map<definitions::EntityType, util::PathingGraph> PathingGraphs;
+    std::map<definitions::EntityType, util::HierarchicalPathingGraph> HierarchicalPathingGraphs;
+    util::PathingQuery PathQuery;
+    RegionMetrics Metrics;
 
 private:
+    struct PathRequest
+    {
+        uint16_t enemy_id;
+        definitions::EntityType type;
+        sf::Vector2f start;
+        sf::Vector2f finish;
+        sf::FloatRect entity_bounds;
+    };
+
+    struct PlayerFlowField
+    {
+        util::FlowField field;
+        int goal_cell = -1;
+    };
+
+    // Every entity type with the same pathing size shares one grid, and every entity chasing the same goal shares one field
+    struct FlowFieldSet
+    {
+        util::FlowGrid grid;
+        util::FlowField convoy;
+        std::map<uint16_t, PlayerFlowField> players;
+    };
+
     definitions::RegionDefinition definition;
+    RegionEventSink* event_sink = &PlayerBroadcastSink::Get();
+    std::map<definitions::EntityType, FlowFieldSet> flow_fields;
+    util::IdAllocator enemy_ids = util::CreateIdAllocator();
+    util::IdAllocator projectile_ids = util::CreateIdAllocator();
+
+    // Rebuilt at the start of every tick. Queries are padded to cover enemy sizes and movement since the rebuild
+    util::SpatialHash enemy_index;
+    std::vector<unsigned> enemy_candidates;
+    float enemy_extent = 0; // Largest half width or height of any indexed enemy
+    float enemy_drift = 0; // Furthest any enemy has moved since the index was rebuilt
+    std::vector<unsigned> updating_enemies;
+
+    // Scheduling for each enemy type, cached from its entity definition when the type is first spawned
+    struct EnemySchedule
+    {
+        definitions::AiDetailThresholds detail;
+        util::Seconds decision_interval = 0;
+    };
+
+    std::map<definitions::EntityType, EnemySchedule> enemy_schedules;
+    std::vector<Enemy*> projectile_targets;
+    std::vector<unsigned> projectile_obstacles;
+
+    // Searches run one at a time in PathQuery, spread across ticks by an expansion budget
+    std::deque<PathRequest> path_requests;
+    std::map<uint16_t, std::vector<sf::Vector2f>> completed_paths;
+    bool path_search_active = false;
+
+    bool hierarchical_pathing = false; // Large regions search clustered graphs instead of one flat visibility graph
     float region_difficulty = 0;
     int num_players = 1;
     util::Seconds region_age = 0; // In seconds
     util::Seconds age_timer = 0;
+    util::Seconds metrics_timer = 0;
     float battery_charge_rate = 0; // Units-per-second
     definitions::MenuEvent current_event;
 
     void updateBattery(sf::Time elapsed);
+    void updateMetrics(sf::Time elapsed);
+    void updateFlowFields();
+    void processPathRequests();
+    void updateEnemyIndex();
+    void updateDetailLevels();
+    void updateEnemies(sf::Time elapsed);
+    void despawnEnemies();
+    void precomputePathing();
+    void preparePathing(definitions::EntityType type, sf::Vector2f pathing_size);
+    void buildPlayerFlowField(const util::FlowGrid& grid, sf::Vector2f player_position, PlayerFlowField& player_field);
     void spawnEnemy(definitions::EntityType type, sf::Vector2f position);
     void spawnEnemy(definitions::EntityType type, sf::Vector2f position, sf::Vector2f pack_position);
     void spawnPack(definitions::EnemyPack pack);
+    unsigned spawnRandomPack(definitions::PackDifficulty difficulty);
     bool spawnWave(sf::Time elapsed);
     void handleProjectiles(sf::Time elapsed);
 };
@@ -0,0 +1,49 @@
+/**************************************************************************************************
+ *  File:       region_events.h
+ *  Class:      RegionEventSink
+ *
+ *  Purpose:    Everything a region and its enemies tell the players about
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "definitions.h"
+#include "game_math.h"
+#include "pathfinding.h"
+#include <cstdint>
+#include <vector>
+
+namespace server
+{
+
+// The server broadcasts every event to the connected players; a simulation without clients can count or drop them
+class RegionEventSink
+{
+public:
+    virtual ~RegionEventSink() = default;
+
+    virtual void EnemyAdded(uint16_t enemy_id, definitions::EntityType type) = 0;
+    virtual void EnemyRemoved(uint16_t enemy_id) = 0;
+    virtual void EnemyAnimationChanged(uint16_t enemy_id, definitions::AnimationType animation, util::Direction direction) = 0;
+    virtual void PathDisplayed(const util::PathingGraph& graph, const std::vector<sf::Vector2f>& path) = 0;
+    virtual void MenuEventStarted(uint16_t event_id) = 0;
+    virtual void MenuEventAdvanced(uint16_t advance_value, bool finish) = 0;
+};
+
+// Sends each event to every player in global::PlayerList
+class PlayerBroadcastSink : public RegionEventSink
+{
+public:
+    static PlayerBroadcastSink& Get();
+
+    void EnemyAdded(uint16_t enemy_id, definitions::EntityType type) override;
+    void EnemyRemoved(uint16_t enemy_id) override;
+    void EnemyAnimationChanged(uint16_t enemy_id, definitions::AnimationType animation, util::Direction direction) override;
+    void PathDisplayed(const util::PathingGraph& graph, const std::vector<sf::Vector2f>& path) override;
+    void MenuEventStarted(uint16_t event_id) override;
+    void MenuEventAdvanced(uint16_t advance_value, bool finish) override;
+};
+
+} // server
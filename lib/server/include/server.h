@@ -48,6 +48,7 @@ private:
     GameState game_state = GameState::Uninitialized;
     sf::Clock clock;
     definitions::Zone current_zone;
+    util::RouteTable zone_routes;
     Region region;
     uint16_t current_region;
     uint16_t next_region;
@@ -56,6 +57,7 @@ private:
 
     void update();
     void listen();
+    void removeDisconnectedPlayers();
     void checkMessages(Player& player);
 
     void startGame();
@@ -10,10 +10,13 @@
 
 #include "new_enemy.h"
 #include "player.h"
+#include "slot_map.h"
 
 namespace server
 {
-    Enemy& GetEnemyById(uint16_t id, std::list<Enemy>& enemies);
-    Player& GetPlayerById(uint16_t id, std::vector<Player>& players);
+    Player& GetPlayerById(uint16_t id);
+    Player* FindPlayer(util::SlotHandle handle); // nullptr if the player has since left
+    util::SlotHandle GetPlayerHandle(uint16_t id);
+    void SetPlayerId(Player& player, uint16_t id); // The player must already be in PlayerList
 
 } // namespace server
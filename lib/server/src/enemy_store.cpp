@@ -0,0 +1,156 @@
+/**************************************************************************************************
+ *  File:       enemy_store.cpp
+ *  Class:      EnemyStore
+ *
+ *  Purpose:    The state every enemy touches each tick, kept in one array per field
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "enemy_store.h"
+#include <cmath>
+
+namespace server {
+namespace {
+
+template<typename T>
+void swapRemove(std::vector<T>& values, unsigned index)
+{
+    values[index] = values.back();
+    values.pop_back();
+}
+
+} // anonymous namespace
+
+void EnemyStore::Reserve(unsigned capacity)
+{
+    Ids.reserve(capacity);
+    Types.reserve(capacity);
+    Positions.reserve(capacity);
+    Velocities.reserve(capacity);
+    Speeds.reserve(capacity);
+    MaxSpeeds.reserve(capacity);
+    Health.reserve(capacity);
+    Behaviors.reserve(capacity);
+    Actions.reserve(capacity);
+    Sizes.reserve(capacity);
+    ReplanTimers.reserve(capacity);
+    HoppingCooldowns.reserve(capacity);
+    Details.reserve(capacity);
+    DeferredTime.reserve(capacity);
+    DetailCountdowns.reserve(capacity);
+    DecisionCountdowns.reserve(capacity);
+}
+
+unsigned EnemyStore::Add(uint16_t id, definitions::EntityType type, sf::Vector2f position)
+{
+    unsigned index = Ids.size();
+
+    Ids.push_back(id);
+    Types.push_back(type);
+    Positions.push_back(position);
+    Velocities.push_back(sf::Vector2f{0, 0});
+    Speeds.push_back(0);
+    MaxSpeeds.push_back(0);
+    Health.push_back(0);
+    Behaviors.push_back(definitions::Behavior::None);
+    Actions.push_back(definitions::Action::None);
+    Sizes.push_back(sf::Vector2f{0, 0});
+    ReplanTimers.push_back(0);
+    HoppingCooldowns.push_back(0);
+    Details.push_back(definitions::AiDetail::Full);
+    DeferredTime.push_back(0);
+    DetailCountdowns.push_back(0);
+    DecisionCountdowns.push_back(0);
+
+    util::InsertSlot(id_slots, id, index);
+
+    return index;
+}
+
+void EnemyStore::Remove(unsigned index)
+{
+    util::EraseSlot(id_slots, Ids[index]);
+    util::MoveSlot(id_slots, Ids.back(), index);
+
+    swapRemove(Ids, index);
+    swapRemove(Types, index);
+    swapRemove(Positions, index);
+    swapRemove(Velocities, index);
+    swapRemove(Speeds, index);
+    swapRemove(MaxSpeeds, index);
+    swapRemove(Health, index);
+    swapRemove(Behaviors, index);
+    swapRemove(Actions, index);
+    swapRemove(Sizes, index);
+    swapRemove(ReplanTimers, index);
+    swapRemove(HoppingCooldowns, index);
+    swapRemove(Details, index);
+    swapRemove(DeferredTime, index);
+    swapRemove(DetailCountdowns, index);
+    swapRemove(DecisionCountdowns, index);
+}
+
+unsigned EnemyStore::IndexOf(uint16_t id) const
+{
+    return util::FindSlot(id_slots, id);
+}
+
+unsigned EnemyStore::IndexOf(util::SlotHandle handle) const
+{
+    return util::FindSlot(id_slots, handle);
+}
+
+util::SlotHandle EnemyStore::GetHandle(uint16_t id) const
+{
+    return util::GetSlotHandle(id_slots, id);
+}
+
+unsigned EnemyStore::Size() const
+{
+    return Ids.size();
+}
+
+network::EnemyData EnemyStore::GetData(unsigned index) const
+{
+    network::EnemyData data{};
+    data.id = Ids[index];
+    data.type = Types[index];
+    data.position = Positions[index];
+    data.health = Health[index];
+
+    return data;
+}
+
+sf::FloatRect EnemyStore::GetBounds(unsigned index) const
+{
+    sf::Vector2f position = Positions[index];
+    sf::Vector2f size = Sizes[index];
+    return sf::FloatRect(position.x - size.x / 2, position.y - size.y / 2, size.x, size.y);
+}
+
+void EnemyStore::AdvanceTimers(util::Seconds elapsed)
+{
+    for (auto& timer : ReplanTimers)
+    {
+        timer += elapsed;
+    }
+
+    for (auto& timer : HoppingCooldowns)
+    {
+        timer += elapsed;
+    }
+
+    for (auto& countdown : DecisionCountdowns)
+    {
+        countdown -= elapsed;
+    }
+}
+
+float EnemyStore::GetPhase(uint16_t id)
+{
+    // Multiples of the golden ratio's fractional part never bunch up
+    return std::fmod(id * 0.618034f, 1.0f);
+}
+
+} // server
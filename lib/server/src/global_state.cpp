@@ -12,6 +12,7 @@ namespace server::global
 {
 
 std::vector<Player> PlayerList;
+util::SlotMap PlayerSlots;
 bool Paused = false;
 bool GatheringPlayers = false;
 bool RegionSelect = false;
@@ -16,6 +16,7 @@
 #include "SFML/System/Sleep.hpp"
 #include <iostream>
 #include <cassert>
+#include <cmath>
 #include <ctime>
 
 using std::cout, std::endl;
@@ -25,54 +26,53 @@ namespace server {
 namespace {
     constexpr bool DISPLAY_PATHS = false;
     constexpr util::PixelsPerSecond NUDGE_SPEED = 10;
+    constexpr util::Seconds REPLAN_INTERVAL = 1;
+    constexpr util::DistanceUnits REPLAN_TOLERANCE = 30;
+    constexpr unsigned FLOW_LOOKAHEAD = 3;
+    constexpr util::Seconds CORPSE_TIME = 10;
 }
 
-Enemy::Enemy(Region* region_ptr, definitions::EntityType enemy_type, sf::Vector2f position) : Enemy{region_ptr, enemy_type, position, position} { }
+Enemy::Enemy(Region* region_ptr, uint16_t enemy_id, definitions::EntityType enemy_type, sf::Vector2f position) : Enemy{region_ptr, enemy_id, enemy_type, position, position} { }
 
-Enemy::Enemy(Region* region_ptr, definitions::EntityType enemy_type, sf::Vector2f position, sf::Vector2f pack_spawn) :
+Enemy::Enemy(Region* region_ptr, uint16_t enemy_id, definitions::EntityType enemy_type, sf::Vector2f position, sf::Vector2f pack_spawn) :
              region{region_ptr}, spawn_position{pack_spawn}
 {
     assert(region_ptr != nullptr);
 
-    static uint16_t identifier = 0;
-    data.id = identifier++;
-    data.position = position;
-    data.type = enemy_type;
-    destination = data.position;
+    store = &region->EnemyStates;
+    store_index = store->Add(enemy_id, enemy_type, position);
+    destination = position;
 
-    definition = definitions::GetEntityDefinition(enemy_type);
-    data.health = definition.base_health;
+    definition = &definitions::GetEntityDefinition(enemy_type);
+    health() = definition->base_health;
 
     animation_tracker = definitions::AnimationTracker::ConstructAnimationTracker(enemy_type);
+    store->Sizes[store_index] = animation_tracker.GetCollisionDimensions();
 
-    current_speed = 0;
-    aggro_target = PlayerList[0].Data.id;
+    aggro_target = GetPlayerHandle(PlayerList[0].Data.id);
     setBehavior(Behavior::None);
-    aggression = definition.base_aggression;
-    aggro_range = definition.aggro_range;
+    aggression = definition->base_aggression;
+    aggro_range = definition->aggro_range;
     flocking_anchor_point = spawn_position;
-    current_max_speed = definition.base_movement_speed;
+    maxSpeed() = definition->base_movement_speed;
 }
 
 void Enemy::Update(sf::Time elapsed)
 {
     animation_tracker.Update(elapsed);
+    store->Sizes[store_index] = animation_tracker.GetCollisionDimensions();
 
-    for (auto& [id, timer] : invulnerability_timers)
+    for (auto& cooldown : attack_cooldowns)
     {
-        timer += elapsed.asSeconds();
+        cooldown += elapsed.asSeconds();
     }
 
-    for (auto& [attack_type, attack] : definition.attacks)
+    if (behavior() == Behavior::Dead)
     {
-        if (attack.has_value())
-        {
-            attack.value().cooldown_timer += elapsed.asSeconds();
-        }
+        corpse_timer += elapsed.asSeconds();
+        Despawn = corpse_timer >= CORPSE_TIME;
     }
 
-    hopping_cooldown_timer += elapsed.asSeconds();
-
     if (checkStuck(elapsed))
     {
         return;
@@ -81,39 +81,76 @@ void Enemy::Update(sf::Time elapsed)
     handleAction(elapsed);
 }
 
-void Enemy::WeaponHit(uint16_t player_id, uint8_t damage, definitions::WeaponKnockback knockback, sf::Vector2f hit_vector, float invulnerability_window)
+// Chooses a behavior or target. Everything else the behaviors do runs in Update, every tick
+void Enemy::Decide()
 {
-    if (invulnerability_timers.find(player_id) == invulnerability_timers.end())
+    if (action() != Action::None)
     {
-        invulnerability_timers[player_id] = 0;
+        return;
     }
-    else if (invulnerability_timers[player_id] < invulnerability_windows[player_id])
+
+    switch (behavior())
     {
-        return;
+        case Behavior::None:
+        {
+            chooseBehavior();
+        }
+        break;
+        case Behavior::Wandering:
+        {
+            // Resting wanderers don't notice players
+            if (wander_state == WanderState::Moving)
+            {
+                aggroPlayer();
+            }
+        }
+        break;
+        case Behavior::Feeding:
+        {
+            if (feeding_state == FeedingState::Moving)
+            {
+                aggroPlayer();
+            }
+        }
+        break;
+        case Behavior::Flocking:
+        {
+            aggroPlayer();
+        }
+        break;
+        default:
+        {
+            // Hunting, stalking and swarming enemies keep their target until they give up on it
+        }
+        break;
     }
-    else if (data.health == 0)
+}
+
+void Enemy::WeaponHit(uint16_t player_id, uint8_t damage, definitions::WeaponKnockback knockback, sf::Vector2f hit_vector, float invulnerability_window)
+{
+    util::Seconds now = region->GetAge();
+    if (health() == 0 || util::IsInvulnerable(invulnerability, player_id, now))
     {
         return;
     }
 
-    if (data.health < damage)
+    if (health() < damage)
     {
-        data.health = 0;
+        health() = 0;
     }
     else
     {
-        data.health -= damage;
+        health() -= damage;
     }
 
-    if (data.health == 0)
+    if (health() == 0)
     {
         setAction(Action::None);
         setBehavior(Behavior::Dead);
-        changeAnimation("Death");
+        changeAnimation(AnimationType::Death);
     }
 
-    invulnerability_timers[player_id] = 0;
-    invulnerability_windows[player_id] = invulnerability_window;
+    util::AddInvulnerability(invulnerability, player_id, now + invulnerability_window, now);
 
     if (knockback.distance > 0)
     {
@@ -128,43 +165,42 @@ void Enemy::WeaponHit(uint16_t player_id, uint8_t damage, definitions::WeaponKno
 
 network::EnemyData Enemy::GetData()
 {
-    return data;
+    return store->GetData(store_index);
 }
 
 Behavior Enemy::GetBehavior()
 {
-    return current_behavior;
+    return behavior();
 }
 
 Action Enemy::GetAction()
 {
-    return current_action;
+    return action();
 }
 
 const sf::FloatRect Enemy::GetBounds()
 {
     // TODO: track origin here somehow
     // TODO: this is actually just a flawed collision dimensions, rip
-    sf::Vector2f size = animation_tracker.GetCurrentAnimation().collision_dimensions;
-    return sf::FloatRect(data.position.x - size.x / 2, data.position.y - size.y / 2, size.x, size.y);
+    return store->GetBounds(store_index);
 }
 
 const sf::FloatRect Enemy::GetBounds(sf::Vector2f position)
 {
-    sf::Vector2f size = animation_tracker.GetCurrentAnimation().collision_dimensions;
+    sf::Vector2f size = store->Sizes[store_index];
     return sf::FloatRect(position.x - size.x / 2, position.y - size.y / 2, size.x, size.y);
 }
 
 const sf::Vector2f Enemy::GetPathingSize()
 {
-    return animation_tracker.GetAnimation("Move").collision_dimensions;
+    return animation_tracker.GetAnimation(AnimationType::Move).collision_dimensions;
 }
 
 int Enemy::GetSiphonRate()
 {
     if (feeding_state == FeedingState::Feeding)
     {
-        return definition.siphon_rate;
+        return definition->siphon_rate;
     }
     else
     {
@@ -172,6 +208,11 @@ int Enemy::GetSiphonRate()
     }
 }
 
+void Enemy::SetStoreIndex(unsigned index)
+{
+    store_index = index;
+}
+
 void Enemy::setBehavior(Behavior behavior)
 {
     wander_state = WanderState::Start;
@@ -181,8 +222,9 @@ void Enemy::setBehavior(Behavior behavior)
     leaping_state = LeapingState::Start;
     flocking_state = FlockingState::Start;
     swarming_state = SwarmingState::Start;
+    goal_field = GoalField::None;
 
-    current_behavior = behavior;
+    store->Behaviors[store_index] = behavior;
 }
 
 void Enemy::setAction(Action action)
@@ -195,7 +237,7 @@ void Enemy::setAction(Action action)
     hopping_state = HoppingState::Start;
     tail_swipe_state = TailSwipeState::Start;
 
-    current_action = action;
+    store->Actions[store_index] = action;
 }
 
 void Enemy::chooseBehavior()
@@ -205,19 +247,19 @@ void Enemy::chooseBehavior()
         return;
     }
 
-    if (definition.behaviors[Behavior::Feeding] && (region->Leyline))
+    if (definition->HasBehavior(Behavior::Feeding) && (region->Leyline))
     {
         setBehavior(Behavior::Feeding);
         return;
     }
 
-    if (definition.behaviors[Behavior::Wandering])
+    if (definition->HasBehavior(Behavior::Wandering))
     {
         setBehavior(Behavior::Wandering);
         return;
     }
 
-    if (definition.behaviors[Behavior::Flocking])
+    if (definition->HasBehavior(Behavior::Flocking))
     {
         setBehavior(Behavior::Flocking);
         return;
@@ -226,28 +268,37 @@ void Enemy::chooseBehavior()
 
 bool Enemy::attack()
 {
-    std::vector<Action> attacks;
-    for (auto& [attack_type, attack] : definition.attacks)
+    std::array<Action, definitions::ACTION_COUNT> attacks;
+    unsigned attack_count = 0;
+    for (size_t i = 0; i < definitions::ACTION_COUNT; ++i)
     {
-        if (attack.has_value() && attack.value().cooldown_timer >= attack.value().cooldown)
+        Action attack_type = static_cast<Action>(i);
+        if (definition->HasAttack(attack_type) && attack_cooldowns[i] >= definition->GetAttack(attack_type).cooldown)
         {
-            attacks.push_back(attack_type);
+            attacks[attack_count++] = attack_type;
         }
     }
 
-    if (attacks.empty())
+    if (attack_count == 0)
     {
         return false;
     }
 
-    std::shuffle(attacks.begin(), attacks.end(), util::RandomGenerator);
+    std::shuffle(attacks.begin(), attacks.begin() + attack_count, util::RandomGenerator);
 
-    for (auto& attack : attacks)
+    const Player* target = getTarget();
+    if (target == nullptr)
     {
-        auto distance = util::Distance(GetPlayerById(aggro_target, PlayerList).Data.position, data.position);
-        if (distance <= definition.attacks[attack].value().range && distance >= definition.attacks[attack].value().minimum_range)
+        return false;
+    }
+
+    for (unsigned i = 0; i < attack_count; ++i)
+    {
+        const definitions::AttackDefinition& attack = definition->GetAttack(attacks[i]);
+        auto distance = util::Distance(target->Data.position, position());
+        if (distance <= attack.range && distance >= attack.minimum_range)
         {
-            setAction(attack);
+            setAction(attacks[i]);
             return true;
         }
     }
@@ -257,7 +308,7 @@ bool Enemy::attack()
 
 void Enemy::handleAction(sf::Time elapsed)
 {
-    switch (current_action)
+    switch (action())
     {
         case Action::Tackling:
         {
@@ -301,16 +352,19 @@ void Enemy::handleAction(sf::Time elapsed)
         break;
     }
 
-    nudge(elapsed);
+    if (detail() == definitions::AiDetail::Full)
+    {
+        nudge(elapsed);
+    }
 }
 
 void Enemy::handleBehavior(sf::Time elapsed)
 {
-    switch (current_behavior)
+    switch (behavior())
     {
         case Behavior::None:
         {
-            chooseBehavior();
+            // Waiting for the next decision
         }
         break;
         case Behavior::Wandering:
@@ -362,16 +416,20 @@ void Enemy::handleBehavior(sf::Time elapsed)
 
 void Enemy::move(sf::Time elapsed)
 {
-    if (data.position == destination || !is_moving)
+    if (position() == destination || !is_moving)
     {
         return;
     }
 
     sf::Vector2f goal = getGoal();
-    sf::Vector2f steering_force = util::TruncateVector(steer(goal), definition.steering_force * elapsed.asSeconds());
-    sf::Vector2f repulsion_force = util::TruncateVector(getRepulsionForce(definition.repulsion_radius), definition.repulsion_force * elapsed.asSeconds());
+    sf::Vector2f steering_force = util::TruncateVector(steer(goal), definition->steering_force * elapsed.asSeconds());
+    sf::Vector2f repulsion_force{0, 0};
+    if (detail() == definitions::AiDetail::Full)
+    {
+        repulsion_force = util::TruncateVector(getRepulsionForce(definition->repulsion_radius), definition->repulsion_force * elapsed.asSeconds());
+    }
 
-    float distance = util::Distance(goal, data.position);
+    float distance = util::Distance(goal, position());
     float threshold = animation_tracker.GetCurrentAnimation().collision_dimensions.x;
     if (distance < threshold * 3)
     {
@@ -385,12 +443,12 @@ void Enemy::move(sf::Time elapsed)
         }
     }
 
-    sf::Vector2f velocity = current_velocity + steering_force + repulsion_force;
+    sf::Vector2f desired_velocity = velocity() + steering_force + repulsion_force;
 
-    if (current_velocity != sf::Vector2f{0, 0})
+    if (velocity() != sf::Vector2f{0, 0})
     {
-        util::AngleDegrees angle_between = util::AngleBetween(current_velocity, goal - data.position);
-        if ((angle_between > 90 && angle_between < 270) || current_speed > current_max_speed)
+        util::AngleDegrees angle_between = util::AngleBetween(velocity(), goal - position());
+        if ((angle_between > 90 && angle_between < 270) || speed() > maxSpeed())
         {
             decelerate(elapsed);
         }
@@ -404,46 +462,48 @@ void Enemy::move(sf::Time elapsed)
         accelerate(elapsed);
     }
 
-    current_velocity = util::TruncateVector(current_velocity + velocity, current_speed);
-    sf::Vector2f step = current_velocity * elapsed.asSeconds();
+    velocity() = util::TruncateVector(velocity() + desired_velocity, speed());
+    sf::Vector2f step = velocity() * elapsed.asSeconds();
 
     takeStep(step);
 }
 
 void Enemy::walk(sf::Time elapsed)
 {
-    if (data.position == destination || !is_moving)
+    if (position() == destination || !is_moving)
     {
         return;
     }
 
     sf::Vector2f goal = getGoal();
-    sf::Vector2f direction = util::Normalize(goal - data.position);
-    current_velocity = direction * definition.walking_speed;
-    sf::Vector2f step = current_velocity * elapsed.asSeconds();
+    sf::Vector2f direction = util::Normalize(goal - position());
+    velocity() = direction * definition->walking_speed;
+    sf::Vector2f step = velocity() * elapsed.asSeconds();
 
     takeStep(step);
 
-    if (util::Distance(goal, data.position) <= definition.walking_speed * elapsed.asSeconds())
+    if (util::Distance(goal, position()) <= definition->walking_speed * elapsed.asSeconds())
     {
-        data.position = goal;
+        position() = goal;
     }
 }
 
 void Enemy::nudge(sf::Time elapsed)
 {
     sf::Vector2f aggragate_direction{0, 0};
+    sf::FloatRect bounds = GetBounds();
 
-    for (auto& enemy : region->Enemies)
+    region->QueryEnemies(bounds, neighbors);
+    for (Enemy* enemy : neighbors)
     {
-        if (enemy.data.id == data.id)
+        if (enemy == this)
         {
             continue;
         }
 
-        if (util::Intersects(GetBounds(), enemy.GetBounds()))
+        if (util::Intersects(bounds, enemy->GetBounds()))
         {
-            sf::Vector2f vector = data.position - enemy.data.position;
+            sf::Vector2f vector = position() - enemy->position();
             aggragate_direction += util::InvertVectorMagnitude(vector, util::Magnitude(vector * 1.2f));
         }
     }
@@ -456,11 +516,13 @@ void Enemy::nudge(sf::Time elapsed)
 
 bool Enemy::takeStep(sf::Vector2f step)
 {
-    sf::FloatRect bounds = GetBounds(data.position + step);
+    sf::FloatRect bounds = GetBounds(position() + step);
     bool collision = false;
 
-    for (auto& obstacle : region->Obstacles)
+    util::QueryObstacles(region->ObstacleIndex, bounds, obstacle_candidates);
+    for (unsigned index : obstacle_candidates)
     {
+        const sf::FloatRect& obstacle = region->Obstacles[index];
         if (!util::Intersects(obstacle, bounds))
         {
             continue;
@@ -468,14 +530,14 @@ bool Enemy::takeStep(sf::Vector2f step)
 
         collision = true;
 
-        sf::FloatRect slide_bounds = GetBounds(data.position + sf::Vector2f{step.x, 0});
+        sf::FloatRect slide_bounds = GetBounds(position() + sf::Vector2f{step.x, 0});
         if (!util::Intersects(obstacle, slide_bounds))
         {
             step.y = 0;
             continue;
         }
 
-        slide_bounds = GetBounds(data.position + sf::Vector2f{0, step.y});
+        slide_bounds = GetBounds(position() + sf::Vector2f{0, step.y});
         if (!util::Intersects(obstacle, slide_bounds))
         {
             step.x = 0;
@@ -483,26 +545,28 @@ bool Enemy::takeStep(sf::Vector2f step)
         }
     }
 
-    data.position += step;
+    position() += step;
 
     return collision;
 }
 
 bool Enemy::checkStuck(sf::Time elapsed)
 {
-    sf::FloatRect bounds = GetBounds(data.position);
+    sf::FloatRect bounds = GetBounds(position());
     sf::Vector2f direction;
 
-    for (auto& obstacle : region->Obstacles)
+    util::QueryObstacles(region->ObstacleIndex, bounds, obstacle_candidates);
+    for (unsigned index : obstacle_candidates)
     {
+        const sf::FloatRect& obstacle = region->Obstacles[index];
         if (util::Intersects(obstacle, bounds))
         {
             sf::Vector2f center;
             center.x = obstacle.left + ((obstacle.left + obstacle.width) / 2);
             center.y = obstacle.top + ((obstacle.top + obstacle.height) / 2);
 
-            direction = util::Normalize(data.position - center);
-            data.position += direction * definition.base_movement_speed * 4.0f * elapsed.asSeconds();
+            direction = util::Normalize(position() - center);
+            position() += direction * definition->base_movement_speed * 4.0f * elapsed.asSeconds();
             return true;
         }
     }
@@ -512,35 +576,113 @@ bool Enemy::checkStuck(sf::Time elapsed)
 
 sf::Vector2f Enemy::getGoal()
 {
-    std::vector<sf::FloatRect> obstacles = region->Obstacles;
-    util::PathingGraph graph = util::AppendPathingGraph(data.position, destination, region->Obstacles, GetBounds(), region->PathingGraphs[data.type]);
-    std::list<sf::Vector2f> path = util::GetPath(graph);
+    // Nobody is close enough to see an enemy below full detail take a shortcut
+    if (detail() != definitions::AiDetail::Full)
+    {
+        return destination;
+    }
 
-    if (DISPLAY_PATHS)
+    if (goal_field != GoalField::None)
     {
-        //if (data.id == 5)
+        const util::FlowGrid& grid = region->GetFlowGrid(type());
+        const util::FlowField& field = (goal_field == GoalField::Convoy) ? region->GetConvoyFlowField(type()) : region->GetPlayerFlowField(type(), aggro_target.id);
+        float cost = util::GetFlowCost(grid, field, position());
+
+        if (cost == 0 && goal_field == GoalField::Player)
         {
-            for (auto& player : PlayerList)
-            {
-                network::ServerMessage::DisplayPath(*player.Socket, graph, path);
-            }
+            return destination;
         }
-        sf::sleep(sf::milliseconds(2));
+
+        if (cost > 0 && std::isfinite(cost))
+        {
+            return util::GetFlowWaypoint(grid, field, region->ObstacleIndex, GetBounds(), position(), FLOW_LOOKAHEAD);
+        }
+
+        // Inside the feeding zone, or cut off from the goal entirely, so fall back to a path search
+    }
+
+    receivePath();
+
+    if (!path_pending && shouldReplan())
+    {
+        replan();
     }
 
-    if (path.empty())
+    if (waypoints.empty())
     {
-        return data.position;
+        // Until the first path arrives, head straight for the destination
+        return (path_pending && !path_planned) ? destination : position();
     }
 
-    return path.front();
+    // Small drifts of the destination are followed without searching again
+    waypoints.back() = destination;
+
+    float threshold = animation_tracker.GetCurrentAnimation().collision_dimensions.x;
+    while (next_waypoint + 1 < waypoints.size() && util::Distance(waypoints[next_waypoint], position()) <= threshold)
+    {
+        ++next_waypoint;
+    }
+
+    return waypoints[next_waypoint];
+}
+
+bool Enemy::shouldReplan()
+{
+    if (!path_planned || replanTimer() >= REPLAN_INTERVAL)
+    {
+        return true;
+    }
+
+    if (util::Distance(destination, path_destination) > REPLAN_TOLERANCE)
+    {
+        return true;
+    }
+
+    if (waypoints.empty())
+    {
+        // Unreachable destinations are only retried when the timer expires
+        return false;
+    }
+
+    return !util::HasLineOfSight(region->ObstacleIndex, GetBounds(), position(), waypoints[next_waypoint]);
+}
+
+void Enemy::replan()
+{
+    // The search runs in the region's path queue, and the old waypoints are followed until the result arrives
+    region->RequestPath(id(), type(), position(), destination, GetBounds());
+    requested_destination = destination;
+    replanTimer() = 0;
+    path_pending = true;
+}
+
+void Enemy::receivePath()
+{
+    if (!path_pending || !region->TakePath(id(), waypoints))
+    {
+        return;
+    }
+
+    next_waypoint = 0;
+    path_destination = requested_destination;
+    path_pending = false;
+    path_planned = true;
+
+    if (DISPLAY_PATHS)
+    {
+        //if (id() == 5)
+        {
+            region->GetEventSink().PathDisplayed(region->GetPathingGraph(type()), waypoints);
+        }
+        sf::sleep(sf::milliseconds(2));
+    }
 }
 
 sf::Vector2f Enemy::steer(sf::Vector2f goal)
 {
-    sf::Vector2f desired_direction = util::Normalize(goal - data.position);
+    sf::Vector2f desired_direction = util::Normalize(goal - position());
 
-    return (desired_direction * current_speed) - current_velocity;
+    return (desired_direction * speed()) - velocity();
 }
 
 void Enemy::accelerate(sf::Time elapsed)
@@ -550,16 +692,16 @@ void Enemy::accelerate(sf::Time elapsed)
         return;
     }
 
-    if (current_speed == current_max_speed)
+    if (speed() == maxSpeed())
     {
         return;
     }
 
-    current_speed += definition.acceleration * elapsed.asSeconds();
+    speed() += definition->acceleration * elapsed.asSeconds();
 
-    if (current_speed > current_max_speed)
+    if (speed() > maxSpeed())
     {
-        current_speed = current_max_speed;
+        speed() = maxSpeed();
     }
 }
 
@@ -570,16 +712,16 @@ void Enemy::decelerate(sf::Time elapsed)
         return;
     }
 
-    if (current_speed == 0)
+    if (speed() == 0)
     {
         return;
     }
 
-    current_speed -= definition.deceleration * elapsed.asSeconds();
+    speed() -= definition->deceleration * elapsed.asSeconds();
 
-    if (current_speed < 0)
+    if (speed() < 0)
     {
-        current_speed = 0;
+        speed() = 0;
     }
 }
 
@@ -587,16 +729,17 @@ sf::Vector2f Enemy::getRepulsionForce(float distance)
 {
     sf::Vector2f aggragate_direction{0, 0};
 
-    for (auto& enemy : region->Enemies)
+    region->QueryEnemies(sf::FloatRect{position().x - distance, position().y - distance, distance * 2, distance * 2}, neighbors);
+    for (Enemy* enemy : neighbors)
     {
-        if (enemy.data.id == data.id)
+        if (enemy == this)
         {
             continue;
         }
 
-        if (util::Distance(enemy.GetBounds().getPosition(), data.position) < distance)
+        if (util::Distance(enemy->GetBounds().getPosition(), position()) < distance)
         {
-            sf::Vector2f vector = data.position - enemy.data.position;
+            sf::Vector2f vector = position() - enemy->position();
             aggragate_direction += util::InvertVectorMagnitude(vector, distance);
         }
     }
@@ -611,7 +754,7 @@ void Enemy::handleWandering(sf::Time elapsed)
         wander_state = WanderState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
     wander_timer += elapsed.asSeconds();
 
     switch (wander_state)
@@ -619,10 +762,10 @@ void Enemy::handleWandering(sf::Time elapsed)
         case WanderState::Start:
         {
             wander_timer = 0;
-            wander_rest_time = util::GetRandomFloat(definition.wander_rest_time_min, definition.wander_rest_time_max);
+            wander_rest_time = util::GetRandomFloat(definition->wander_rest_time_min, definition->wander_rest_time_max);
             wander_state = WanderState::Resting;
-            changeAnimation("Rest");
-            aggro_range = definition.aggro_range;
+            changeAnimation(AnimationType::Rest);
+            aggro_range = definition->aggro_range;
             is_moving = false;
             is_walking = true;
             [[fallthrough]];
@@ -636,20 +779,21 @@ void Enemy::handleWandering(sf::Time elapsed)
                 sf::Vector2f new_destination;
                 for (int i = 0; i < max_attempts; ++i)
                 {
-                    if (util::Distance(data.position, spawn_position) < 75)
+                    if (util::Distance(position(), spawn_position) < 75)
                     {
-                        new_destination = util::GetRandomPositionFromPoint(data.position, 50, 200);
+                        new_destination = util::GetRandomPositionFromPoint(position(), 50, 200);
                     }
                     else
                     {
-                        new_destination = util::GetRandomPositionInCone(data.position, 50, 200, util::VectorToAngle(spawn_position - data.position), 120);
+                        new_destination = util::GetRandomPositionInCone(position(), 50, 200, util::VectorToAngle(spawn_position - position()), 120);
                     }
 
-                    if (!util::Contains(region->Obstacles, new_destination))
+                    if (!util::Contains(region->ObstacleIndex, new_destination))
                     {
                         wander_state = WanderState::Moving;
-                        changeAnimation("Move");
+                        changeAnimation(AnimationType::Move);
                         destination = new_destination;
+                        goal_field = GoalField::None;
                         is_moving = true;
                         break;
                     }
@@ -659,12 +803,10 @@ void Enemy::handleWandering(sf::Time elapsed)
         break;
         case WanderState::Moving:
         {
-            if (data.position == destination)
+            if (position() == destination)
             {
                 wander_state = WanderState::Start;
             }
-
-            aggroPlayer();
         }
         break;
     }
@@ -678,29 +820,24 @@ void Enemy::handleFeeding(sf::Time elapsed)
         feeding_state = FeedingState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
 
     switch (feeding_state)
     {
         case FeedingState::Start:
         {
             feeding_state = FeedingState::Moving;
-            changeAnimation("Move");
+            changeAnimation(AnimationType::Move);
             destination = region->Convoy.Position;
+            goal_field = GoalField::Convoy;
             is_moving = true;
             is_walking = false;
-            aggro_range = definition.aggro_range / 2;
+            aggro_range = definition->aggro_range / 2;
             [[fallthrough]];
         }
         case FeedingState::Moving:
         {
             float distance = getConvoyDistance();
-
-            if (aggroPlayer())
-            {
-                return;
-            }
-
             if (distance <= 300)
             {
                 destination = getTargetConvoyPoint();
@@ -710,11 +847,11 @@ void Enemy::handleFeeding(sf::Time elapsed)
         break;
         case FeedingState::Approaching:
         {
-            if (util::Distance(destination, data.position) <= definition.feeding_range)
+            if (util::Distance(destination, position()) <= definition->feeding_range)
             {
                 is_moving = false;
                 feeding_state = FeedingState::Feeding;
-                changeAnimation("Feed");
+                changeAnimation(AnimationType::Feed);
             }
         }
         break;
@@ -733,9 +870,14 @@ void Enemy::handleHunting(sf::Time elapsed)
         hunting_state = HuntingState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
     hunting_timer += elapsed.asSeconds();
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
 
     switch (hunting_state)
     {
@@ -743,25 +885,26 @@ void Enemy::handleHunting(sf::Time elapsed)
         {
             hunting_timer = 0;
             hunting_state = HuntingState::Moving;
-            changeAnimation("Move");
-            destination = target.Data.position;
+            changeAnimation(AnimationType::Move);
+            destination = target->Data.position;
+            goal_field = GoalField::Player;
             is_moving = true;
             is_walking = false;
-            combat_range = definition.combat_range * util::GetRandomFloat(0.9, 1.3);
+            combat_range = definition->combat_range * util::GetRandomFloat(0.9, 1.3);
             [[fallthrough]];
         }
         case HuntingState::Moving:
         {
-            destination = target.Data.position;
-            float distance = util::Distance(destination, data.position);
+            destination = target->Data.position;
+            float distance = util::Distance(destination, position());
 
-            if (distance >= definition.leash_range)
+            if (distance >= definition->leash_range)
             {
                 setBehavior(Behavior::None);
                 return;
             }
 
-            if (definition.behaviors[Behavior::Stalking])
+            if (definition->HasBehavior(Behavior::Stalking))
             {
                 if (distance <= combat_range)
                 {
@@ -788,10 +931,15 @@ void Enemy::handleStalking(sf::Time elapsed)
         stalking_state = StalkingState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
     stalking_timer += elapsed.asSeconds();
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
-    float distance = util::Distance(data.position, target.Data.position);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    float distance = util::Distance(position(), target->Data.position);
 
     switch (stalking_state)
     {
@@ -804,7 +952,7 @@ void Enemy::handleStalking(sf::Time elapsed)
         case StalkingState::Choosing:
         {
             stalking_timer = 0;
-            if (distance > definition.combat_range * 1.2)
+            if (distance > definition->combat_range * 1.2)
             {
                 setBehavior(definitions::Behavior::None);
                 return;
@@ -816,7 +964,7 @@ void Enemy::handleStalking(sf::Time elapsed)
                 return;
             }
 
-            if (distance <= definition.close_quarters_range && hopping_cooldown_timer >= definition.hopping_cooldown)
+            if (distance <= definition->close_quarters_range && hoppingCooldown() >= definition->hopping_cooldown)
             {
                 hop_direction = util::Direction::Back;
                 setAction(definitions::Action::Hopping);
@@ -831,7 +979,7 @@ void Enemy::handleStalking(sf::Time elapsed)
             {
                 attack();
             }
-            else if (hop && hopping_cooldown_timer >= definition.hopping_cooldown)
+            else if (hop && hoppingCooldown() >= definition->hopping_cooldown)
             {
                 float weight = util::GetRandomFloat(0, 1);
                 if (weight < 0.5)
@@ -854,12 +1002,12 @@ void Enemy::handleStalking(sf::Time elapsed)
             stalking_timer = 0;
             stalking_rest_time = util::GetRandomFloat(0.5f, 1.0f);
             stalking_state = StalkingState::Resting;
-            changeAnimation("Rest");
+            changeAnimation(AnimationType::Rest);
             [[fallthrough]];
         }
         case StalkingState::Resting:
         {
-            if (distance <= definition.close_quarters_range || stalking_timer >= stalking_rest_time)
+            if (distance <= definition->close_quarters_range || stalking_timer >= stalking_rest_time)
             {
                 stalking_state = StalkingState::Choosing;
             }
@@ -876,7 +1024,7 @@ void Enemy::handleFlocking(sf::Time elapsed)
         flocking_state = FlockingState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
 
     switch (flocking_state)
     {
@@ -885,13 +1033,13 @@ void Enemy::handleFlocking(sf::Time elapsed)
             is_moving = true;
             is_walking = false;
             flocking_state = FlockingState::Flocking;
-            changeAnimation("Move");
+            changeAnimation(AnimationType::Move);
             [[fallthrough]];
         }
         case FlockingState::Flocking:
         {
             destination = flocking_anchor_point;
-            aggroPlayer();
+            goal_field = GoalField::None;
         }
         break;
     }
@@ -904,11 +1052,16 @@ void Enemy::handleSwarming(sf::Time elapsed)
         swarming_state = SwarmingState::Start;
     }
 
-    previous_behavior = current_behavior;
+    previous_behavior = behavior();
     swarming_rest_timer += elapsed.asSeconds();
 
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
-    double target_distance = util::Distance(data.position, target.Data.position);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    double target_distance = util::Distance(position(), target->Data.position);
 
     switch (swarming_state)
     {
@@ -917,13 +1070,14 @@ void Enemy::handleSwarming(sf::Time elapsed)
             is_moving = true;
             is_walking = false;
             swarming_state = SwarmingState::Approaching;
-            changeAnimation("Move");
+            changeAnimation(AnimationType::Move);
             [[fallthrough]];
         }
         case SwarmingState::Approaching:
         {
-            destination = target.Data.position;
-            if (target_distance <= definition.combat_range)
+            destination = target->Data.position;
+            goal_field = GoalField::Player;
+            if (target_distance <= definition->combat_range)
             {
                 setAction(Action::Tackling);
                 swarming_state = SwarmingState::Followthrough;
@@ -932,16 +1086,17 @@ void Enemy::handleSwarming(sf::Time elapsed)
         break;
         case SwarmingState::Followthrough:
         {
-            swarming_rest_point = (util::Normalize(current_velocity) * static_cast<float>(definition.combat_range)) + data.position;
+            swarming_rest_point = (util::Normalize(velocity()) * static_cast<float>(definition->combat_range)) + position();
             swarming_rest_timer = 0;
-            current_max_speed = definition.base_movement_speed;
-            swarming_rest_time = util::GetRandomFloat(definition.swarming_rest_time_min, definition.swarming_rest_time_max);
+            maxSpeed() = definition->base_movement_speed;
+            swarming_rest_time = util::GetRandomFloat(definition->swarming_rest_time_min, definition->swarming_rest_time_max);
             swarming_state = SwarmingState::Resting;
             [[fallthrough]];
         }
         case SwarmingState::Resting:
         {
             destination = swarming_rest_point;
+            goal_field = GoalField::None;
             if (swarming_rest_timer >= swarming_rest_time)
             {
                 setBehavior(Behavior::None);
@@ -961,9 +1116,15 @@ void Enemy::handleLeaping(sf::Time elapsed)
         {
             leaping_timer = 0;
             leaping_state = LeapingState::Windup;
-            changeAnimation("LeapWindup");
-            animation_time = animation_tracker.GetAnimationTime("LeapWindup");
-            leaping_direction = util::Normalize(GetPlayerById(aggro_target, PlayerList).Data.position - data.position);
+            changeAnimation(AnimationType::LeapWindup);
+            animation_time = animation_tracker.GetAnimationTime(AnimationType::LeapWindup);
+            const Player* target = getTarget();
+            if (target == nullptr)
+            {
+                return;
+            }
+
+            leaping_direction = util::Normalize(target->Data.position - position());
             [[fallthrough]];
         }
         case LeapingState::Windup:
@@ -972,7 +1133,7 @@ void Enemy::handleLeaping(sf::Time elapsed)
             {
                 leaping_state = LeapingState::Leaping;
                 leaping_timer = 0;
-                animation_time = animation_tracker.GetAnimationTime("Leap");
+                animation_time = animation_tracker.GetAnimationTime(AnimationType::Leap);
             }
         }
         break;
@@ -980,14 +1141,14 @@ void Enemy::handleLeaping(sf::Time elapsed)
         {
             if (leaping_timer >= animation_time)
             {
-                definition.attacks[Action::Leaping].value().cooldown_timer = 0;
+                attack_cooldowns[static_cast<size_t>(Action::Leaping)] = 0;
                 leaping_timer = 0;
                 leaping_state = LeapingState::Resting;
-                changeAnimation("LeapResting");
-                animation_time = animation_tracker.GetAnimationTime("LeapResting");
+                changeAnimation(AnimationType::LeapResting);
+                animation_time = animation_tracker.GetAnimationTime(AnimationType::LeapResting);
             }
 
-            util::PixelsPerSecond travel_speed = definition.attacks[Action::Leaping].value().travel_distance / animation_time;
+            util::PixelsPerSecond travel_speed = definition->GetAttack(Action::Leaping).travel_distance / animation_time;
 
             sf::Vector2f step = leaping_direction * travel_speed * elapsed.asSeconds();
             bool collision = takeStep(step);
@@ -997,23 +1158,23 @@ void Enemy::handleLeaping(sf::Time elapsed)
             {
                 if (util::Intersects(player.GetBounds(), GetBounds()))
                 {
-                    player.AddIncomingAttack(definitions::AttackEvent{data.id, definition.attacks[Action::Leaping].value(), data.position});
-                    definition.attacks[Action::Leaping].value().cooldown_timer = 0;
+                    player.AddIncomingAttack(definitions::AttackEvent{id(), definition->GetAttack(Action::Leaping), position()});
+                    attack_cooldowns[static_cast<size_t>(Action::Leaping)] = 0;
                     leaping_timer = 0;
                     leaping_state = LeapingState::Resting;
-                    changeAnimation("LeapResting");
-                    animation_time = animation_tracker.GetAnimationTime("LeapResting");
+                    changeAnimation(AnimationType::LeapResting);
+                    animation_time = animation_tracker.GetAnimationTime(AnimationType::LeapResting);
                     break;
                 }
             }
 
             if (collision)
             {
-                definition.attacks[Action::Leaping].value().cooldown_timer = 0;
+                attack_cooldowns[static_cast<size_t>(Action::Leaping)] = 0;
                 leaping_timer = 0;
                 leaping_state = LeapingState::Resting;
-                changeAnimation("LeapResting");
-                animation_time = animation_tracker.GetAnimationTime("LeapResting");
+                changeAnimation(AnimationType::LeapResting);
+                animation_time = animation_tracker.GetAnimationTime(AnimationType::LeapResting);
             }
         }
         break;
@@ -1038,7 +1199,7 @@ void Enemy::handleKnockback(sf::Time elapsed)
         {
             knockback_timer = 0;
             knockback_state = KnockbackState::Knockback;
-            changeAnimation("Knockback");
+            changeAnimation(AnimationType::Knockback);
             [[fallthrough]];
         }
         case KnockbackState::Knockback:
@@ -1079,24 +1240,30 @@ void Enemy::handleStunned(sf::Time elapsed)
 void Enemy::handleTackling(sf::Time elapsed)
 {
     tackle_timer += elapsed.asSeconds();
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
 
     switch (tackling_state)
     {
         case TacklingState::Start:
         {
             tackling_state = TacklingState::Tackle;
-            current_max_speed = definition.base_movement_speed * 2.5;
+            maxSpeed() = definition->base_movement_speed * 2.5;
             [[fallthrough]];
         }
         case TacklingState::Tackle:
         {
-            destination = target.Data.position;
+            destination = target->Data.position;
+            goal_field = GoalField::Player;
             move(elapsed);
 
-            if (tackle_timer >= definition.attacks[Action::Tackling].value().duration)
+            if (tackle_timer >= definition->GetAttack(Action::Tackling).duration)
             {
-                current_max_speed = definition.base_movement_speed;
+                maxSpeed() = definition->base_movement_speed;
                 tackle_timer = 0;
                 setAction(Action::None);
             }
@@ -1106,9 +1273,9 @@ void Enemy::handleTackling(sf::Time elapsed)
             {
                 if (util::Intersects(player.GetBounds(), GetBounds()))
                 {
-                    player.AddIncomingAttack(definitions::AttackEvent{data.id, definition.attacks[Action::Tackling].value(), data.position});
-                    definition.attacks[Action::Tackling].value().cooldown_timer = 0;
-                    current_max_speed = definition.base_movement_speed;
+                    player.AddIncomingAttack(definitions::AttackEvent{id(), definition->GetAttack(Action::Tackling), position()});
+                    attack_cooldowns[static_cast<size_t>(Action::Tackling)] = 0;
+                    maxSpeed() = definition->base_movement_speed;
                     tackle_timer = 0;
                     setAction(Action::None);
                 }
@@ -1121,19 +1288,24 @@ void Enemy::handleTackling(sf::Time elapsed)
 void Enemy::handleHopping(sf::Time elapsed)
 {
     hopping_timer += elapsed.asSeconds();
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
-    sf::Vector2f target_direction = util::Normalize(target.Data.position - data.position);
-    float distance = util::Distance(data.position, target.Data.position);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    sf::Vector2f target_direction = util::Normalize(target->Data.position - position());
+    float distance = util::Distance(position(), target->Data.position);
 
     switch (hopping_state)
     {
         case HoppingState::Start:
         {
-            changeAnimation("HopWindup", hop_direction);
-            animation_time = animation_tracker.GetAnimationTime("HopWindup");
+            changeAnimation(AnimationType::HopWindup, hop_direction);
+            animation_time = animation_tracker.GetAnimationTime(AnimationType::HopWindup);
             hopping_state = HoppingState::Windup;
             hopping_timer = 0;
-            hopping_cooldown_timer = 0;
+            hoppingCooldown() = 0;
             [[fallthrough]];
         }
         case HoppingState::Windup:
@@ -1146,7 +1318,7 @@ void Enemy::handleHopping(sf::Time elapsed)
                 }
                 else
                 {
-                    util::AngleDegrees relative_angle = util::ToDegrees(std::acos((definition.hopping_distance * definition.hopping_distance) / (2 * distance * definition.hopping_distance)));
+                    util::AngleDegrees relative_angle = util::ToDegrees(std::acos((definition->hopping_distance * definition->hopping_distance) / (2 * distance * definition->hopping_distance)));
                     if (hop_direction == util::Direction::Left)
                     {
                         relative_angle = -relative_angle;
@@ -1159,14 +1331,14 @@ void Enemy::handleHopping(sf::Time elapsed)
 
                 hopping_timer = 0;
                 hopping_state = HoppingState::Hopping;
-                changeAnimation("Hop", hop_direction);
-                animation_time = animation_tracker.GetAnimationTime("Hop");
+                changeAnimation(AnimationType::Hop, hop_direction);
+                animation_time = animation_tracker.GetAnimationTime(AnimationType::Hop);
             }
         }
         break;
         case HoppingState::Hopping:
         {
-            float speed = definition.hopping_distance / animation_time;
+            float speed = definition->hopping_distance / animation_time;
             sf::Vector2f step = hop_vector * speed * elapsed.asSeconds();
             takeStep(step);
 
@@ -1182,8 +1354,13 @@ void Enemy::handleHopping(sf::Time elapsed)
 void Enemy::handleTailSwipe(sf::Time elapsed)
 {
     tail_swipe_timer += elapsed.asSeconds();
-    const Player& target = GetPlayerById(aggro_target, PlayerList);
-    sf::Vector2f target_direction = util::Normalize(target.Data.position - data.position);
+    const Player* target = getTarget();
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    sf::Vector2f target_direction = util::Normalize(target->Data.position - position());
 
     switch (tail_swipe_state)
     {
@@ -1191,9 +1368,9 @@ void Enemy::handleTailSwipe(sf::Time elapsed)
         {
             tail_swipe_state = TailSwipeState::Swipe;
             tail_swipe_timer = 0;
-            changeAnimation("TailSwipe", util::GetOctalDirection(util::VectorToAngle(target_direction)));
+            changeAnimation(AnimationType::TailSwipe, util::GetOctalDirection(util::VectorToAngle(target_direction)));
             definitions::AnimationVariant variant = definitions::GetAnimationVariant(util::GetOctalDirection(util::VectorToAngle(target_direction)));
-            animation_time = animation_tracker.GetAnimationTime(definitions::AnimationIdentifier{"TailSwipe", variant});
+            animation_time = animation_tracker.GetAnimationTime(AnimationType::TailSwipe, variant);
             [[fallthrough]];
         }
         case TailSwipeState::Swipe:
@@ -1210,19 +1387,17 @@ void Enemy::handleTailSwipe(sf::Time elapsed)
 
             if (damage_frame)
             {
-                auto attack_hitboxes = animation_tracker.GetAttackHitboxes();
-
-                for (auto& hitbox : attack_hitboxes)
+                for (sf::FloatRect hitbox : animation_tracker.GetAttackHitboxes())
                 {
-                    hitbox.left += data.position.x;
-                    hitbox.top += data.position.y;
+                    hitbox.left += position().x;
+                    hitbox.top += position().y;
 
                     // check for a hit
                     for (auto& player : PlayerList)
                     {
                         if (util::Intersects(player.GetBounds(), hitbox))
                         {
-                            player.AddIncomingAttack(definitions::AttackEvent{data.id, definition.attacks[Action::TailSwipe].value(), data.position});
+                            player.AddIncomingAttack(definitions::AttackEvent{id(), definition->GetAttack(Action::TailSwipe), position()});
                         }
                     }
                 }
@@ -1230,7 +1405,7 @@ void Enemy::handleTailSwipe(sf::Time elapsed)
 
             if (tail_swipe_timer > animation_time)
             {
-                definition.attacks[Action::TailSwipe].value().cooldown_timer = 0;
+                attack_cooldowns[static_cast<size_t>(Action::TailSwipe)] = 0;
                 setAction(Action::None);
             }
         }
@@ -1238,26 +1413,25 @@ void Enemy::handleTailSwipe(sf::Time elapsed)
     }
 }
 
-void Enemy::changeAnimation(definitions::AnimationName animation_name)
+void Enemy::changeAnimation(AnimationType animation)
 {
-    changeAnimation(animation_name, util::Direction::None);
+    changeAnimation(animation, util::Direction::None);
 }
 
-void Enemy::changeAnimation(definitions::AnimationName animation_name, util::Direction direction)
+void Enemy::changeAnimation(AnimationType animation, util::Direction direction)
 {
-    for (auto& player : PlayerList)
-    {
-        network::ServerMessage::ChangeEnemyAnimation(*player.Socket, data.id, animation_name, direction);
-    }
+    region->GetEventSink().EnemyAnimationChanged(id(), animation, direction);
 
     if (direction == util::Direction::None)
     {
-        animation_tracker.SetAnimation(animation_name);
+        animation_tracker.SetAnimation(animation);
     }
     else
     {
-        animation_tracker.SetAnimation(animation_name, definitions::GetAnimationVariant(direction));
+        animation_tracker.SetAnimation(animation, definitions::GetAnimationVariant(direction));
     }
+
+    store->Sizes[store_index] = animation_tracker.GetCollisionDimensions();
 }
 
 std::optional<uint16_t> Enemy::playerInRange(float aggro_distance)
@@ -1268,7 +1442,7 @@ std::optional<uint16_t> Enemy::playerInRange(float aggro_distance)
 
     for (auto& player : PlayerList)
     {
-        float distance = util::Distance(player.Data.position, data.position);
+        float distance = util::Distance(player.Data.position, position());
         if (distance <= aggro_distance && distance < lowest_distance)
         {
             lowest_distance = distance;
@@ -1287,9 +1461,22 @@ std::optional<uint16_t> Enemy::playerInRange(float aggro_distance)
     }
 }
 
+// The target can leave the game at any time, in which case the enemy goes back to choosing what to do
+const Player* Enemy::getTarget()
+{
+    const Player* target = FindPlayer(aggro_target);
+    if (target == nullptr)
+    {
+        setAction(Action::None);
+        setBehavior(Behavior::None);
+    }
+
+    return target;
+}
+
 bool Enemy::aggroPlayer()
 {
-    if (!(definition.behaviors[Behavior::Hunting] || definition.behaviors[Behavior::Swarming]))
+    if (!(definition->HasBehavior(Behavior::Hunting) || definition->HasBehavior(Behavior::Swarming)))
     {
         return false;
     }
@@ -1297,12 +1484,12 @@ bool Enemy::aggroPlayer()
     auto target = playerInRange(aggro_range);
     if (target.has_value())
     {
-        aggro_target = target.value();
-        if (definition.behaviors[Behavior::Hunting])
+        aggro_target = GetPlayerHandle(target.value());
+        if (definition->HasBehavior(Behavior::Hunting))
         {
             setBehavior(Behavior::Hunting);
         }
-        else if (definition.behaviors[Behavior::Swarming])
+        else if (definition->HasBehavior(Behavior::Swarming))
         {
             setBehavior(Behavior::Swarming);
         }
@@ -1315,51 +1502,38 @@ bool Enemy::aggroPlayer()
 sf::Vector2f Enemy::getTargetConvoyPoint()
 {
     sf::FloatRect convoy_bounds = region->Convoy.GetBounds();
-    sf::FloatRect feeding_zone = convoy_bounds;
-    int zone_width = 80;
-    feeding_zone.left -= zone_width;
-    feeding_zone.top -= zone_width;
-    feeding_zone.width += zone_width * 2;
-    feeding_zone.height += zone_width * 2;
+    sf::FloatRect feeding_zone = region->GetFeedingZone();
 
-    if (util::Contains(feeding_zone, data.position))
+    if (util::Contains(feeding_zone, position()))
     {
-        return data.position;
+        return position();
     }
 
     sf::Vector2f inner_point;
     sf::Vector2f outer_point;
-    util::IntersectionPoint(convoy_bounds, util::LineVector{data.position, region->Convoy.Position - data.position}, inner_point);
-    util::IntersectionPoint(feeding_zone, util::LineVector{data.position, region->Convoy.Position - data.position}, outer_point);
+    util::IntersectionPoint(convoy_bounds, util::LineVector{position(), region->Convoy.Position - position()}, inner_point);
+    util::IntersectionPoint(feeding_zone, util::LineVector{position(), region->Convoy.Position - position()}, outer_point);
 
-    float min_distance = util::Distance(data.position, outer_point);
-    float max_distance = util::Distance(data.position, inner_point);
-    util::AngleDegrees angle = util::VectorToAngle(region->Convoy.Position - data.position);
+    float min_distance = util::Distance(position(), outer_point);
+    float max_distance = util::Distance(position(), inner_point);
+    util::AngleDegrees angle = util::VectorToAngle(region->Convoy.Position - position());
 
     bool collision;
     sf::Vector2f goal;
 
     do
     {
-        goal = util::GetRandomPositionInCone(data.position, min_distance, max_distance, angle, 120);
+        goal = util::GetRandomPositionInCone(position(), min_distance, max_distance, angle, 120);
     }
     while (!util::Contains(feeding_zone, goal));
 
     do
     {
-        collision = false;
-        for (auto& obstacle : region->Obstacles)
-        {
-            if (util::Intersects(obstacle, GetBounds(goal)))
-            {
-                collision = true;
-                break;
-            }
-        }
+        collision = util::Intersects(region->ObstacleIndex, GetBounds(goal));
 
         if (collision)
         {
-            goal -= util::Normalize(goal - data.position) * animation_tracker.GetCurrentAnimation().collision_dimensions.x;
+            goal -= util::Normalize(goal - position()) * animation_tracker.GetCurrentAnimation().collision_dimensions.x;
         }
     }
     while (collision);
@@ -1372,9 +1546,9 @@ float Enemy::getConvoyDistance()
     sf::FloatRect convoy_bounds = region->Convoy.GetBounds();
 
     sf::Vector2f point;
-    util::IntersectionPoint(convoy_bounds, util::LineVector{data.position, region->Convoy.Position - data.position}, point);
+    util::IntersectionPoint(convoy_bounds, util::LineVector{position(), region->Convoy.Position - position()}, point);
 
-    return util::Distance(data.position, point);
+    return util::Distance(position(), point);
 }
 
 } // server
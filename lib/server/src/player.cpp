@@ -28,14 +28,11 @@ namespace {
     constexpr float KNOCKBACK_UNITS_PER_SECOND = 350;
     constexpr util::Seconds INVULNERABILITY_WINDOW = 2;
 
-    bool checkForCollisions(sf::FloatRect target, std::vector<sf::FloatRect>& obstacles, sf::FloatRect bounds)
+    bool checkForCollisions(sf::FloatRect target, const util::ObstacleGrid& obstacles, sf::FloatRect bounds)
     {
-        for (auto& obstacle : obstacles)
+        if (util::Intersects(obstacles, target))
         {
-            if (util::Intersects(target, obstacle))
-            {
-                return true;
-            }
+            return true;
         }
 
         if (!util::Intersects(target, bounds))
@@ -60,12 +57,7 @@ void Player::Update(sf::Time elapsed, Region& region)
     attack_timer += elapsed.asSeconds();
     movement_override_timer += elapsed.asSeconds();
 
-    for (auto& [id, timer] : invulnerability_timers)
-    {
-        timer += elapsed.asSeconds();
-    }
-
-    processIncomingAttacks();
+    processIncomingAttacks(region.GetAge());
     handleMovement(elapsed, region);
 
     if (Attacking)
@@ -157,13 +149,10 @@ void Player::Damage(int damage_value)
 
 bool Player::SpawnProjectile(definitions::Projectile& out_projectile)
 {
-    static uint16_t projectile_id = 0;
-
     if (spawn_projectile)
     {
         sf::Vector2f attack_vector = util::AngleToVector(current_attack_angle + util::GetRandomInt(-weapon.projectile_spread / 2, weapon.projectile_spread / 2));
         definitions::Projectile projectile;
-        projectile.id = projectile_id++;
         projectile.velocity = attack_vector * static_cast<float>(weapon.projectile_speed);
         projectile.position = Data.position - attack_vector * static_cast<float>(weapon.offset);
         projectile.owner = Data.id;
@@ -225,6 +214,11 @@ void Player::AddIncomingAttack(definitions::AttackEvent attack)
     attack_events.push(attack);
 }
 
+void Player::ClearInvulnerability()
+{
+    util::ClearInvulnerability(invulnerability);
+}
+
 void Player::handleMovement(sf::Time elapsed, Region& region)
 {
     sf::Vector2f step = velocity * elapsed.asSeconds();
@@ -266,13 +260,19 @@ void Player::handleAttack(sf::Time elapsed, Region& region)
 
             util::LineSegment sword = GetSwordLocation();
 
-            for (auto& enemy : region.Enemies)
+            util::ClearRects(enemy_bounds);
+            for (unsigned i = 0; i < region.EnemyStates.Size(); ++i)
             {
-                sf::FloatRect bounds = enemy.GetBounds();
+                util::AddRect(enemy_bounds, region.EnemyStates.GetBounds(i));
+            }
 
-                if (util::Intersects(bounds, sword))
+            util::Intersects(enemy_bounds, sword, enemy_hits);
+
+            for (unsigned i = 0; i < enemy_hits.size(); ++i)
+            {
+                if (enemy_hits[i])
                 {
-                    enemy.WeaponHit(Data.id, weapon.damage, weapon.knockback, enemy.GetData().position - Data.position, weapon.invulnerability_window);
+                    region.Enemies[i].WeaponHit(Data.id, weapon.damage, weapon.knockback, region.EnemyStates.Positions[i] - Data.position, weapon.invulnerability_window);
                 }
             }
         }
@@ -292,8 +292,14 @@ void Player::handleAttack(sf::Time elapsed, Region& region)
 
             bool collision = false;
             sf::Vector2f point;
-            for (auto& rect : region.Obstacles)
+
+            // The shot is a ray, but nothing past the far side of the region can be hit
+            float reach = util::Magnitude(sf::Vector2f{region.Bounds.width, region.Bounds.height}) * 2;
+            util::QueryObstacles(region.ObstacleIndex, util::LineSegment{Data.position, Data.position + attack_vector * reach}, obstacle_candidates);
+
+            for (unsigned index : obstacle_candidates)
             {
+                const sf::FloatRect& rect = region.Obstacles[index];
                 sf::Vector2f temp;
                 if (util::IntersectionPoint(rect, util::LineVector{Data.position, attack_vector}, temp))
                 {
@@ -309,33 +315,32 @@ void Player::handleAttack(sf::Time elapsed, Region& region)
                 }
             }
 
-            uint16_t target_enemy_id = region.Enemies.front().GetData().id;
+            unsigned target_index = 0;
             bool enemy_hit = false;
-            for (auto& enemy : region.Enemies)
+            for (unsigned i = 0; i < region.EnemyStates.Size(); ++i)
             {
                 sf::Vector2f temp;
-                if (util::IntersectionPoint(enemy.GetBounds(), util::LineVector{Data.position, attack_vector}, temp))
+                if (util::IntersectionPoint(region.EnemyStates.GetBounds(i), util::LineVector{Data.position, attack_vector}, temp))
                 {
                     if (!collision)
                     {
                         collision = true;
                         point = temp;
                         enemy_hit = true;
-                        target_enemy_id = enemy.GetData().id;
+                        target_index = i;
                     }
                     else if (util::Distance(Data.position, temp) < util::Distance(Data.position, point))
                     {
                         point = temp;
                         enemy_hit = true;
-                        target_enemy_id = enemy.GetData().id;
+                        target_index = i;
                     }
                 }
             }
 
             if (enemy_hit)
             {
-                Enemy& enemy = GetEnemyById(target_enemy_id, region.Enemies);
-                enemy.WeaponHit(Data.id, weapon.damage, weapon.knockback, enemy.GetData().position - Data.position, weapon.invulnerability_window);
+                region.Enemies[target_index].WeaponHit(Data.id, weapon.damage, weapon.knockback, region.EnemyStates.Positions[target_index] - Data.position, weapon.invulnerability_window);
             }
 
             Attacking = false;
@@ -351,14 +356,14 @@ void Player::takeStep(sf::Vector2f step, Region& region)
     if (!Attacking)
     {
         new_position = Data.position + step;
-        collision = checkForCollisions(getBoundingBox(new_position), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(new_position), region.ObstacleIndex, region.Bounds);
     }
 
     if (collision)
     {
         collision = false;
         sf::Vector2f partial{new_position.x, Data.position.y};
-        collision = checkForCollisions(getBoundingBox(partial), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(partial), region.ObstacleIndex, region.Bounds);
 
         if (!collision)
         {
@@ -370,7 +375,7 @@ void Player::takeStep(sf::Vector2f step, Region& region)
     {
         collision = false;
         sf::Vector2f partial{Data.position.x, new_position.y};
-        collision = checkForCollisions(getBoundingBox(partial), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(partial), region.ObstacleIndex, region.Bounds);
 
         if (!collision)
         {
@@ -391,14 +396,14 @@ void Player::step(sf::Time elapsed, Region& region)
     if (!Attacking)
     {
         new_position = Data.position + velocity * elapsed.asSeconds();
-        collision = checkForCollisions(getBoundingBox(new_position), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(new_position), region.ObstacleIndex, region.Bounds);
     }
 
     if (collision)
     {
         collision = false;
         sf::Vector2f partial{new_position.x, Data.position.y};
-        collision = checkForCollisions(getBoundingBox(partial), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(partial), region.ObstacleIndex, region.Bounds);
 
         if (!collision)
         {
@@ -410,7 +415,7 @@ void Player::step(sf::Time elapsed, Region& region)
     {
         collision = false;
         sf::Vector2f partial{Data.position.x, new_position.y};
-        collision = checkForCollisions(getBoundingBox(partial), region.Obstacles, region.Bounds);
+        collision = checkForCollisions(getBoundingBox(partial), region.ObstacleIndex, region.Bounds);
 
         if (!collision)
         {
@@ -424,24 +429,19 @@ void Player::step(sf::Time elapsed, Region& region)
     }
 }
 
-void Player::processIncomingAttacks()
+void Player::processIncomingAttacks(util::Seconds now)
 {
     while (!attack_events.empty())
     {
         definitions::AttackEvent event = attack_events.front();
         attack_events.pop();
 
-        if (invulnerability_timers.find(event.source_id) == invulnerability_timers.end())
-        {
-            invulnerability_timers[event.source_id] = 0;
-        }
-        else if (invulnerability_timers[event.source_id] < invulnerability_windows[event.source_id])
+        if (util::IsInvulnerable(invulnerability, event.source_id, now))
         {
             return;
         }
 
-        invulnerability_timers[event.source_id] = 0;
-        invulnerability_windows[event.source_id] = INVULNERABILITY_WINDOW;
+        util::AddInvulnerability(invulnerability, event.source_id, now + INVULNERABILITY_WINDOW, now);
 
         Damage(event.attack.damage);
         movement_override_time = event.attack.knockback_distance / KNOCKBACK_UNITS_PER_SECOND;
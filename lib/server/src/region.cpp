@@ -8,36 +8,55 @@
  *
  *************************************************************************************************/
 #include "region.h"
+#include "baked_pathing.h"
 #include "definitions.h"
 #include "game_math.h"
 #include "global_state.h"
+#include "util.h"
 #include <algorithm>
 #include <iostream>
+#include <set>
 #include <stdexcept>
 
-using network::ClientMessage, network::ServerMessage;
 using server::global::PlayerList;
+using server::global::PlayerSlots;
 
 using std::cout, std::cerr, std::endl;
 
 namespace server {
+namespace {
+    constexpr bool DISPLAY_METRICS = false;
+    constexpr util::Seconds METRICS_WINDOW = 1;
+    constexpr float FLOW_CELL_SIZE = 25;
+    constexpr float OBSTACLE_CELL_SIZE = 100;
+    constexpr unsigned HIERARCHICAL_OBSTACLE_COUNT = 300;
+    constexpr float HIERARCHICAL_REGION_EXTENT = 5000;
+    constexpr float PATHING_CLUSTER_SIZE = 500;
+    constexpr float ENEMY_CELL_SIZE = 64;
+    constexpr float ENEMY_INDEX_SLACK = 20; // Further than an enemy moves in one tick at full detail
+    constexpr util::DistanceUnits DETAIL_HYSTERESIS = 50; // Enemies drop a level of detail only this far past its range
+    constexpr unsigned ENEMY_CAPACITY = 1024; // Reserved up front; a busy leyline grows past it only once
+    constexpr unsigned PROJECTILE_CAPACITY = 256;
+    constexpr unsigned PATH_SEARCH_BUDGET = 2000; // Node expansions and visibility tests per tick, shared by every queued path request
+    constexpr int FEEDING_ZONE_WIDTH = 80;
+}
 
 Region::Region() { }
 
-Region::Region(definitions::RegionType region_type, int player_count, float battery_level) : BatteryLevel{battery_level}, num_players{player_count}
+Region::Region(definitions::RegionType region_type, int player_count, float battery_level) :
+               Region{region_type, player_count, battery_level, PlayerBroadcastSink::Get()} { }
+
+Region::Region(definitions::RegionType region_type, int player_count, float battery_level, RegionEventSink& events) :
+               BatteryLevel{battery_level}, event_sink{&events}, num_players{player_count}
 {
     definition = definitions::GetRegionDefinition(region_type);
 
     Bounds = definition.bounds;
     Convoy = definition.convoy;
 
-    for (auto& obstacle : definition.obstacles)
-    {
-        Obstacles.push_back(obstacle.bounds);
-    }
-
-    auto convoy_collisions = Convoy.GetCollisions();
-    Obstacles.insert(Obstacles.end(), convoy_collisions.begin(), convoy_collisions.end());
+    Obstacles = definition.GetCollisions();
+    ObstacleIndex = util::CreateObstacleGrid(Obstacles, OBSTACLE_CELL_SIZE);
+    hierarchical_pathing = Obstacles.size() > HIERARCHICAL_OBSTACLE_COUNT || std::max(Bounds.width, Bounds.height) > HIERARCHICAL_REGION_EXTENT;
 
     Leyline = definition.leyline;
 
@@ -51,12 +70,15 @@ Region::Region(definitions::RegionType region_type, int player_count, float batt
         global::Paused = true;
         global::MenuEvent = true;
         current_event = definitions::GetNextMenuEvent();
-        for (auto& p : PlayerList)
-        {
-            ServerMessage::SetMenuEvent(*p.Socket, current_event.event_id);
-        }
+        event_sink->MenuEventStarted(current_event.event_id);
     }
 
+    EnemyStates.Reserve(ENEMY_CAPACITY);
+    Enemies.reserve(ENEMY_CAPACITY);
+    Projectiles.reserve(PROJECTILE_CAPACITY);
+
+    precomputePathing();
+
     for (auto& pack : definition.enemy_packs)
     {
         spawnPack(pack);
@@ -72,18 +94,38 @@ void Region::Update(sf::Time elapsed)
 
     region_age += elapsed.asSeconds();
 
-    for (auto& enemy : Enemies)
+    sf::Clock phase_clock;
+    auto end_phase = [&](RegionPhase phase)
     {
-        enemy.Update(elapsed);
-    }
+        Metrics.phase_times[static_cast<size_t>(phase)] = phase_clock.restart().asMicroseconds();
+    };
+
+    updateFlowFields();
+    end_phase(RegionPhase::FlowFields);
+    processPathRequests();
+    end_phase(RegionPhase::PathRequests);
+    despawnEnemies();
+    end_phase(RegionPhase::Despawn);
+    updateEnemyIndex();
+    end_phase(RegionPhase::EnemyIndex);
+    updateDetailLevels();
+    end_phase(RegionPhase::DetailLevels);
+    EnemyStates.AdvanceTimers(elapsed.asSeconds());
+    updateEnemies(elapsed);
+    end_phase(RegionPhase::Enemies);
 
     handleProjectiles(elapsed);
+    end_phase(RegionPhase::Projectiles);
     updateBattery(elapsed);
+    updateMetrics(elapsed);
+    end_phase(RegionPhase::Battery);
 
     if (definition.leyline)
     {
         spawnWave(elapsed);
     }
+
+    end_phase(RegionPhase::Spawning);
 }
 
 namespace {
@@ -136,10 +178,7 @@ bool Region::AdvanceMenuEvent(uint16_t winner, uint16_t& out_event_id, uint16_t&
         return false;
     }
 
-    for (auto& player : PlayerList)
-    {
-        ServerMessage::AdvanceMenuEvent(*player.Socket, winning_link.value, winning_link.finish);
-    }
+    event_sink->MenuEventAdvanced(winning_link.value, winning_link.finish);
 
     if (!winning_link.finish)
     {
@@ -157,14 +196,402 @@ bool Region::AdvanceMenuEvent(uint16_t winner, uint16_t& out_event_id, uint16_t&
     return false;
 }
 
+sf::FloatRect Region::GetFeedingZone()
+{
+    sf::FloatRect feeding_zone = Convoy.GetBounds();
+    feeding_zone.left -= FEEDING_ZONE_WIDTH;
+    feeding_zone.top -= FEEDING_ZONE_WIDTH;
+    feeding_zone.width += FEEDING_ZONE_WIDTH * 2;
+    feeding_zone.height += FEEDING_ZONE_WIDTH * 2;
+
+    return feeding_zone;
+}
+
+const util::FlowGrid& Region::GetFlowGrid(definitions::EntityType type)
+{
+    return flow_fields.at(type).grid;
+}
+
+const util::FlowField& Region::GetConvoyFlowField(definitions::EntityType type)
+{
+    return flow_fields.at(type).convoy;
+}
+
+const util::FlowField& Region::GetPlayerFlowField(definitions::EntityType type, uint16_t player_id)
+{
+    FlowFieldSet& field_set = flow_fields.at(type);
+
+    auto iterator = field_set.players.find(player_id);
+    if (iterator == field_set.players.end())
+    {
+        iterator = field_set.players.emplace(player_id, PlayerFlowField{}).first;
+        buildPlayerFlowField(field_set.grid, GetPlayerById(player_id).Data.position, iterator->second);
+    }
+
+    return iterator->second.field;
+}
+
+void Region::RequestPath(uint16_t enemy_id, definitions::EntityType type, sf::Vector2f start, sf::Vector2f finish, sf::FloatRect entity_bounds)
+{
+    completed_paths.erase(enemy_id);
+    path_requests.push_back(PathRequest{enemy_id, type, start, finish, entity_bounds});
+}
+
+bool Region::TakePath(uint16_t enemy_id, std::vector<sf::Vector2f>& out_path)
+{
+    auto iterator = completed_paths.find(enemy_id);
+    if (iterator == completed_paths.end())
+    {
+        return false;
+    }
+
+    out_path = std::move(iterator->second);
+    completed_paths.erase(iterator);
+    return true;
+}
+
+const util::PathingGraph& Region::GetPathingGraph(definitions::EntityType type)
+{
+    if (hierarchical_pathing)
+    {
+        return HierarchicalPathingGraphs[type].graph;
+    }
+
+    return PathingGraphs[type];
+}
+
+void Region::QueryEnemies(sf::FloatRect area, std::vector<Enemy*>& out_enemies)
+{
+    float padding = enemy_extent + std::max(ENEMY_INDEX_SLACK, enemy_drift);
+    sf::FloatRect padded_area{area.left - padding, area.top - padding, area.width + padding * 2, area.height + padding * 2};
+    util::QuerySpatialHash(enemy_index, padded_area, enemy_candidates);
+
+    // Keep the order of the enemy list, so results do not depend on how enemies were bucketed
+    std::sort(enemy_candidates.begin(), enemy_candidates.end());
+
+    out_enemies.clear();
+    for (unsigned index : enemy_candidates)
+    {
+        out_enemies.push_back(&Enemies[index]);
+    }
+}
+
+Enemy& Region::GetEnemy(uint16_t enemy_id)
+{
+    unsigned index = EnemyStates.IndexOf(enemy_id);
+    if (index == EnemyStore::INVALID_INDEX)
+    {
+        throw std::runtime_error("Enemy Id not found.");
+    }
+
+    return Enemies[index];
+}
+
+void Region::updateEnemyIndex()
+{
+    enemy_extent = 0;
+    for (auto& size : EnemyStates.Sizes)
+    {
+        enemy_extent = std::max(enemy_extent, std::max(size.x, size.y) / 2);
+    }
+
+    // Enemy positions are the centers of their bounds
+    util::BuildSpatialHash(enemy_index, EnemyStates.Positions, ENEMY_CELL_SIZE);
+    enemy_drift = 0;
+}
+
+void Region::updateDetailLevels()
+{
+    using definitions::AiDetail, definitions::Behavior, definitions::Action;
+
+    for (unsigned i = 0; i < EnemyStates.Size(); ++i)
+    {
+        AiDetail current = EnemyStates.Details[i];
+        AiDetail detail = AiDetail::Full;
+
+        // Enemies with a target keep full detail, since they path around obstacles towards it
+        Behavior behavior = EnemyStates.Behaviors[i];
+        bool idle = EnemyStates.Actions[i] == Action::None &&
+                    (behavior == Behavior::None || behavior == Behavior::Wandering || behavior == Behavior::Flocking || behavior == Behavior::Dead);
+
+        if (idle)
+        {
+            sf::Vector2f position = EnemyStates.Positions[i];
+            float distance = util::Distance(position, Convoy.Position);
+            for (auto& player : PlayerList)
+            {
+                distance = std::min(distance, static_cast<float>(util::Distance(position, player.Data.position)));
+            }
+
+            const definitions::AiDetailThresholds& thresholds = enemy_schedules[EnemyStates.Types[i]].detail;
+            auto beyond = [&](util::DistanceUnits range, AiDetail level)
+            {
+                return distance > range + ((current < level) ? DETAIL_HYSTERESIS : 0);
+            };
+
+            if (beyond(thresholds.minimal_range, AiDetail::Minimal))
+            {
+                detail = AiDetail::Minimal;
+            }
+            else if (beyond(thresholds.reduced_range, AiDetail::Reduced))
+            {
+                detail = AiDetail::Reduced;
+            }
+        }
+
+        if (detail != current && detail != AiDetail::Full)
+        {
+            // Spread the updates of enemies that drop detail together across the interval
+            const definitions::AiDetailThresholds& thresholds = enemy_schedules[EnemyStates.Types[i]].detail;
+            util::Seconds interval = (detail == AiDetail::Reduced) ? thresholds.reduced_interval : thresholds.minimal_interval;
+            EnemyStates.DetailCountdowns[i] = interval * EnemyStore::GetPhase(EnemyStates.Ids[i]);
+        }
+
+        EnemyStates.Details[i] = detail;
+    }
+}
+
+void Region::updateEnemies(sf::Time elapsed)
+{
+    // Enemies at full detail update every tick, and the rest only when their countdown runs out. DeferredTime
+    // becomes the time each updating enemy simulates, including any deferred before it was promoted to full detail
+    updating_enemies.clear();
+    for (unsigned i = 0; i < EnemyStates.Size(); ++i)
+    {
+        EnemyStates.DeferredTime[i] += elapsed.asSeconds();
+        if (EnemyStates.Details[i] != definitions::AiDetail::Full)
+        {
+            EnemyStates.DetailCountdowns[i] -= elapsed.asSeconds();
+            if (EnemyStates.DetailCountdowns[i] > 0)
+            {
+                continue;
+            }
+
+            const definitions::AiDetailThresholds& thresholds = enemy_schedules[EnemyStates.Types[i]].detail;
+            EnemyStates.DetailCountdowns[i] += (EnemyStates.Details[i] == definitions::AiDetail::Reduced) ? thresholds.reduced_interval : thresholds.minimal_interval;
+        }
+
+        updating_enemies.push_back(i);
+    }
+
+    // Behavior and target selection only run when an enemy's decision countdown has run out, so each type's
+    // decisions spread across its interval instead of all running every tick
+    sf::Clock decision_clock;
+    Metrics.decisions = 0;
+    for (unsigned index : updating_enemies)
+    {
+        util::Seconds& countdown = EnemyStates.DecisionCountdowns[index];
+        if (countdown > 0)
+        {
+            continue;
+        }
+
+        Enemies[index].Decide();
+        ++Metrics.decisions;
+
+        // Decisions missed below full detail are not made up
+        util::Seconds interval = enemy_schedules[EnemyStates.Types[index]].decision_interval;
+        countdown = (countdown + interval > 0) ? countdown + interval : interval;
+    }
+
+    Metrics.decision_time = decision_clock.getElapsedTime().asMicroseconds();
+
+    for (unsigned index : updating_enemies)
+    {
+        sf::Vector2f start = EnemyStates.Positions[index];
+        Enemies[index].Update(sf::seconds(EnemyStates.DeferredTime[index]));
+        enemy_drift = std::max(enemy_drift, static_cast<float>(util::Distance(start, EnemyStates.Positions[index])));
+        EnemyStates.DeferredTime[index] = 0;
+    }
+
+    Metrics.enemy_updates = updating_enemies.size();
+}
+
+void Region::processPathRequests()
+{
+    unsigned budget = PATH_SEARCH_BUDGET;
+
+    while (!path_requests.empty() && budget > 0)
+    {
+        PathRequest& request = path_requests.front();
+
+        if (!path_search_active)
+        {
+            bool prepared = hierarchical_pathing ? HierarchicalPathingGraphs.find(request.type) != HierarchicalPathingGraphs.end()
+                                                 : PathingGraphs.find(request.type) != PathingGraphs.end();
+            if (!prepared)
+            {
+                cerr << "No pathing graph prepared for enemy type " << static_cast<int>(request.type) << endl;
+                completed_paths[request.enemy_id].clear();
+                path_requests.pop_front();
+                continue;
+            }
+
+            // The enemy kept moving while the request waited its turn, so the search starts from where it is now
+            unsigned index = EnemyStates.IndexOf(request.enemy_id);
+            if (index != EnemyStore::INVALID_INDEX)
+            {
+                sf::Vector2f offset = EnemyStates.Positions[index] - request.start;
+                request.start += offset;
+                request.entity_bounds.left += offset.x;
+                request.entity_bounds.top += offset.y;
+            }
+
+            if (hierarchical_pathing)
+            {
+                const util::HierarchicalPathingGraph& graph = HierarchicalPathingGraphs.at(request.type);
+                util::AppendPathingGraph(request.start, request.finish, ObstacleIndex, request.entity_bounds, graph, PathQuery);
+                util::BeginPath(graph.graph, PathQuery);
+            }
+            else
+            {
+                const util::PathingGraph& graph = PathingGraphs.at(request.type);
+                util::AppendPathingGraph(request.start, request.finish, ObstacleIndex, request.entity_bounds, graph, PathQuery);
+                util::BeginPath(graph, PathQuery);
+            }
+
+            path_search_active = true;
+            budget -= std::min(budget, PathQuery.tested_nodes);
+        }
+
+        unsigned expanded = PathQuery.expanded_nodes;
+        util::PathStatus status;
+        if (hierarchical_pathing)
+        {
+            status = util::ContinuePath(HierarchicalPathingGraphs.at(request.type), ObstacleIndex, PathQuery, budget);
+        }
+        else
+        {
+            status = util::ContinuePath(PathingGraphs.at(request.type), PathQuery, budget);
+        }
+
+        budget -= std::min(budget, PathQuery.expanded_nodes - expanded);
+
+        if (status == util::PathStatus::Searching)
+        {
+            break;
+        }
+
+        // A failed search delivers an empty path, which the enemy treats as unreachable
+        completed_paths[request.enemy_id] = PathQuery.path;
+        path_requests.pop_front();
+        path_search_active = false;
+        ++Metrics.replans;
+    }
+
+    Metrics.queued_paths = path_requests.size();
+    Metrics.path_work = PATH_SEARCH_BUDGET - budget;
+}
+
+void Region::precomputePathing()
+{
+    // Build everything a spawn table can produce up front, so a type's first spawn never stalls a tick
+    std::set<definitions::EntityType> types;
+    for (auto& pack : definition.enemy_packs)
+    {
+        for (auto& spawn : pack.spawns)
+        {
+            types.insert(spawn.type);
+        }
+    }
+
+    if (definition.leyline)
+    {
+        for (auto& pack : definitions::GetEnemyPacksByDifficulty(region_difficulty))
+        {
+            for (auto& spawn : pack.spawns)
+            {
+                types.insert(spawn.type);
+            }
+        }
+    }
+
+    for (auto type : types)
+    {
+        preparePathing(type, definitions::AnimationTracker::ConstructAnimationTracker(type).GetAnimation(definitions::AnimationType::Move).collision_dimensions);
+    }
+}
+
+void Region::preparePathing(definitions::EntityType type, sf::Vector2f pathing_size)
+{
+    if (hierarchical_pathing)
+    {
+        if (HierarchicalPathingGraphs.find(type) == HierarchicalPathingGraphs.end())
+        {
+            HierarchicalPathingGraphs[type] = util::CreateHierarchicalPathingGraph(ObstacleIndex, Bounds, pathing_size, PATHING_CLUSTER_SIZE);
+        }
+    }
+    else if (PathingGraphs.find(type) == PathingGraphs.end())
+    {
+        // Shipped regions are baked offline; anything edited since then is generated here instead
+        uint64_t source_hash = util::HashPathingSource(Obstacles, pathing_size);
+        if (!util::LoadPathingGraph(util::GetBakedGraphPath(source_hash), source_hash, PathingGraphs[type]))
+        {
+            cout << "No baked pathing graph for this region, generating one." << endl;
+            PathingGraphs[type] = util::CreatePathingGraph(ObstacleIndex, pathing_size);
+        }
+    }
+
+    if (flow_fields.find(type) == flow_fields.end())
+    {
+        FlowFieldSet& field_set = flow_fields[type];
+        field_set.grid = util::CreateFlowGrid(ObstacleIndex, Bounds, pathing_size, FLOW_CELL_SIZE);
+        util::BuildFlowField(field_set.grid, GetFeedingZone(), field_set.convoy);
+    }
+}
+
+void Region::updateFlowFields()
+{
+    // Player fields are only rebuilt once their player has moved into a different cell
+    for (auto& [type, field_set] : flow_fields)
+    {
+        // Fields of players who have left are dropped
+        std::erase_if(field_set.players, [](auto& entry) { return util::FindSlot(PlayerSlots, entry.first) == util::SLOT_NOT_FOUND; });
+
+        for (auto& [player_id, player_field] : field_set.players)
+        {
+            sf::Vector2f player_position = GetPlayerById(player_id).Data.position;
+            if (util::GetFlowCell(field_set.grid, player_position) != player_field.goal_cell)
+            {
+                buildPlayerFlowField(field_set.grid, player_position, player_field);
+            }
+        }
+    }
+}
+
+void Region::buildPlayerFlowField(const util::FlowGrid& grid, sf::Vector2f player_position, PlayerFlowField& player_field)
+{
+    sf::FloatRect goal_area{player_position.x - FLOW_CELL_SIZE / 2, player_position.y - FLOW_CELL_SIZE / 2, FLOW_CELL_SIZE, FLOW_CELL_SIZE};
+    util::BuildFlowField(grid, goal_area, player_field.field);
+    player_field.goal_cell = util::GetFlowCell(grid, player_position);
+}
+
+void Region::updateMetrics(sf::Time elapsed)
+{
+    metrics_timer += elapsed.asSeconds();
+    if (metrics_timer < METRICS_WINDOW)
+    {
+        return;
+    }
+
+    Metrics.replans_per_second = Metrics.replans / metrics_timer;
+    Metrics.replans = 0;
+    metrics_timer = 0;
+
+    if (DISPLAY_METRICS)
+    {
+        cout << "Replans per second: " << Metrics.replans_per_second << " (" << Enemies.size() << " enemies, " << Metrics.enemy_updates << " updated, " << Metrics.decisions << " decisions in " << Metrics.decision_time << "us, " << Metrics.queued_paths << " queued paths)" << endl;
+    }
+}
+
 void Region::updateBattery(sf::Time elapsed)
 {
     int siphon_rate = 0;
-    for (auto& enemy : Enemies)
+    for (unsigned i = 0; i < EnemyStates.Size(); ++i)
     {
-        if (enemy.GetBehavior() == definitions::Behavior::Feeding)
+        if (EnemyStates.Behaviors[i] == definitions::Behavior::Feeding)
         {
-            siphon_rate += enemy.GetSiphonRate();
+            siphon_rate += Enemies[i].GetSiphonRate();
         }
     }
 
@@ -203,16 +630,52 @@ bool Region::spawnWave(sf::Time elapsed)
     for (int i = 0; i < num_players; ++i)
     {
         // TODO: Vary pack difficulty for partial region difficulties; like difficulty 1.4 should be a 60% chance for difficulty 1 and 40% for difficulty 2
-        definitions::EnemyPack pack = definitions::GetEnemyPackByDifficulty(region_difficulty);
-        pack.position.x = util::GetRandomFloat(definition.spawn_zone.left, definition.spawn_zone.left + definition.spawn_zone.width);
-        pack.position.y = util::GetRandomFloat(definition.spawn_zone.top, definition.spawn_zone.top + definition.spawn_zone.height);
-
-        spawnPack(pack);
+        spawnRandomPack(region_difficulty);
     }
 
     return true;
 }
 
+unsigned Region::SpawnHorde(unsigned enemy_count, definitions::PackDifficulty difficulty)
+{
+    // Whole packs, so the last one may take the horde past the count
+    unsigned spawned = 0;
+    while (spawned < enemy_count)
+    {
+        unsigned pack_size = spawnRandomPack(difficulty);
+        if (pack_size == 0)
+        {
+            break;
+        }
+
+        spawned += pack_size;
+    }
+
+    return spawned;
+}
+
+RegionEventSink& Region::GetEventSink()
+{
+    return *event_sink;
+}
+
+util::Seconds Region::GetAge()
+{
+    return region_age;
+}
+
+unsigned Region::spawnRandomPack(definitions::PackDifficulty difficulty)
+{
+    definitions::EnemyPack pack = definitions::GetEnemyPackByDifficulty(difficulty);
+    pack.position.x = util::GetRandomFloat(definition.spawn_zone.left, definition.spawn_zone.left + definition.spawn_zone.width);
+    pack.position.y = util::GetRandomFloat(definition.spawn_zone.top, definition.spawn_zone.top + definition.spawn_zone.height);
+
+    unsigned enemy_count = Enemies.size();
+    spawnPack(pack);
+
+    return Enemies.size() - enemy_count;
+}
+
 void Region::spawnEnemy(definitions::EntityType type, sf::Vector2f position)
 {
     spawnEnemy(type, position, position);
@@ -233,54 +696,138 @@ void Region::spawnPack(definitions::EnemyPack pack)
 
 void Region::spawnEnemy(definitions::EntityType type, sf::Vector2f position, sf::Vector2f pack_position)
 {
-    Enemy enemy(this, type, position, pack_position);
-    Enemies.push_back(enemy);
-    for (auto& player : PlayerList)
+    uint16_t id;
+    if (!util::AllocateId(enemy_ids, id))
     {
-        ServerMessage::AddEnemy(*player.Socket, enemy.GetData().id, type);
+        cerr << "Every enemy id is in use; the spawn was dropped." << endl;
+        return;
     }
 
-    if (PathingGraphs.find(type) == PathingGraphs.end())
+    Enemy& enemy = Enemies.emplace_back(this, id, type, position, pack_position);
+    event_sink->EnemyAdded(id, type);
+
+    if (enemy_schedules.find(type) == enemy_schedules.end())
     {
-        PathingGraphs[type] = util::CreatePathingGraph(Obstacles, enemy.GetPathingSize());
+        const definitions::EntityDefinition& entity = definitions::GetEntityDefinition(type);
+        enemy_schedules[type] = EnemySchedule{entity.ai_detail, entity.decision_interval};
     }
+
+    // Offset each enemy's first decision, so a pack spawned together doesn't decide on the same tick
+    EnemyStates.DecisionCountdowns[EnemyStates.IndexOf(id)] = enemy_schedules[type].decision_interval * EnemyStore::GetPhase(id);
+
+    // Normally already built at load; this only catches types spawned outside the region's spawn tables
+    preparePathing(type, enemy.GetPathingSize());
+}
+
+void Region::despawnEnemies()
+{
+    // Backwards, so the enemy swapped into a removed one's place has already been checked
+    for (unsigned i = Enemies.size(); i-- > 0;)
+    {
+        if (!Enemies[i].Despawn)
+        {
+            continue;
+        }
+
+        uint16_t id = EnemyStates.Ids[i];
+
+        // Its id will be handed out again, so nothing queued for it can be left behind
+        if (path_search_active && path_requests.front().enemy_id == id)
+        {
+            path_search_active = false;
+        }
+
+        std::erase_if(path_requests, [id](const PathRequest& request) { return request.enemy_id == id; });
+        completed_paths.erase(id);
+        event_sink->EnemyRemoved(id);
+
+        EnemyStates.Remove(i);
+        if (i != Enemies.size() - 1)
+        {
+            Enemies[i] = std::move(Enemies.back());
+            Enemies[i].SetStoreIndex(i);
+        }
+
+        Enemies.pop_back();
+        util::FreeId(enemy_ids, id);
+    }
+}
+
+void Region::AddProjectile(definitions::Projectile projectile)
+{
+    if (!util::AllocateId(projectile_ids, projectile.id))
+    {
+        cerr << "Every projectile id is in use; the projectile was dropped." << endl;
+        return;
+    }
+
+    Projectiles.push_back(projectile);
 }
 
 void Region::handleProjectiles(sf::Time elapsed)
 {
-    auto iterator = Projectiles.begin();
-    while (iterator != Projectiles.end())
+    unsigned i = 0;
+    while (i < Projectiles.size())
     {
-        auto& projectile = *iterator;
+        auto& projectile = Projectiles[i];
+        sf::Vector2f previous_position = projectile.position;
         projectile.position += projectile.velocity * elapsed.asSeconds();
-        bool destroy = false;
+
+        // Everything the projectile passed through this tick is tested, so fast projectiles can't skip over a target.
+        // Only the first thing along the sweep is hit
+        util::LineSegment sweep{previous_position, projectile.position};
+        float obstacle_fraction = 2;
+        float fraction;
+
+        util::QueryObstacles(ObstacleIndex, sweep, projectile_obstacles);
+        for (unsigned index : projectile_obstacles)
+        {
+            if (util::IntersectionFraction(ObstacleIndex.obstacles[index], sweep, fraction) && fraction < obstacle_fraction)
+            {
+                obstacle_fraction = fraction;
+            }
+        }
+
+        bool destroy = obstacle_fraction <= 1;
         if (projectile.hostile == false)
         {
-            for (auto& enemy : Enemies)
+            sf::FloatRect swept_area{std::min(sweep.p1.x, sweep.p2.x), std::min(sweep.p1.y, sweep.p2.y),
+                                     std::abs(sweep.p2.x - sweep.p1.x), std::abs(sweep.p2.y - sweep.p1.y)};
+            QueryEnemies(swept_area, projectile_targets);
+
+            Enemy* target = nullptr;
+            float target_fraction = obstacle_fraction;
+            for (Enemy* enemy : projectile_targets)
             {
-                if (util::Contains(enemy.GetBounds(), projectile.position))
+                if (util::IntersectionFraction(enemy->GetBounds(), sweep, fraction) && fraction < target_fraction)
                 {
-                    enemy.WeaponHit(projectile.owner, projectile.damage, projectile.knockback, -projectile.velocity, projectile.invulnerability_window);
-                    destroy = true;
+                    target = enemy;
+                    target_fraction = fraction;
                 }
             }
-        }
 
-        for (auto& obstacle : Obstacles)
-        {
-            if (util::Contains(obstacle, projectile.position))
+            if (target != nullptr)
             {
+                target->WeaponHit(projectile.owner, projectile.damage, projectile.knockback, -projectile.velocity, projectile.invulnerability_window);
                 destroy = true;
             }
         }
 
+        // Not every region is walled in, and a missed shot would otherwise keep its id forever
+        if (!util::Contains(Bounds, projectile.position))
+        {
+            destroy = true;
+        }
+
         if (destroy)
         {
-            iterator = Projectiles.erase(iterator);
+            util::FreeId(projectile_ids, projectile.id);
+            projectile = Projectiles.back();
+            Projectiles.pop_back();
         }
         else
         {
-            ++iterator;
+            ++i;
         }
     }
 }
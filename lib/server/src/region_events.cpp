@@ -0,0 +1,74 @@
+/**************************************************************************************************
+ *  File:       region_events.cpp
+ *  Class:      RegionEventSink
+ *
+ *  Purpose:    Everything a region and its enemies tell the players about
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "region_events.h"
+#include "global_state.h"
+#include "messaging.h"
+
+using network::ServerMessage;
+using server::global::PlayerList;
+
+namespace server
+{
+
+PlayerBroadcastSink& PlayerBroadcastSink::Get()
+{
+    static PlayerBroadcastSink sink;
+    return sink;
+}
+
+void PlayerBroadcastSink::EnemyAdded(uint16_t enemy_id, definitions::EntityType type)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::AddEnemy(*player.Socket, enemy_id, type);
+    }
+}
+
+void PlayerBroadcastSink::EnemyRemoved(uint16_t enemy_id)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::RemoveEnemy(*player.Socket, enemy_id);
+    }
+}
+
+void PlayerBroadcastSink::EnemyAnimationChanged(uint16_t enemy_id, definitions::AnimationType animation, util::Direction direction)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::ChangeEnemyAnimation(*player.Socket, enemy_id, animation, direction);
+    }
+}
+
+void PlayerBroadcastSink::PathDisplayed(const util::PathingGraph& graph, const std::vector<sf::Vector2f>& path)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::DisplayPath(*player.Socket, graph, path);
+    }
+}
+
+void PlayerBroadcastSink::MenuEventStarted(uint16_t event_id)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::SetMenuEvent(*player.Socket, event_id);
+    }
+}
+
+void PlayerBroadcastSink::MenuEventAdvanced(uint16_t advance_value, bool finish)
+{
+    for (auto& player : PlayerList)
+    {
+        ServerMessage::AdvanceMenuEvent(*player.Socket, advance_value, finish);
+    }
+}
+
+} // server
@@ -22,6 +22,7 @@
 using std::cout, std::cerr, std::endl;
 using network::ClientMessage, network::ServerMessage;
 using server::global::PlayerList;
+using server::global::PlayerSlots;
 
 namespace server {
 
@@ -62,8 +63,8 @@ void Server::Start()
 
 uint16_t Server::getPlayerUid()
 {
-    // 0 is reserved
-    static uint16_t player_id = 1;
+    // 0 is reserved for players that haven't been given an id
+    static uint16_t player_id = network::UNASSIGNED_PLAYER_ID + 1;
     return player_id++;
 }
 
@@ -78,18 +79,15 @@ void Server::update()
         return;
     }
 
+    removeDisconnectedPlayers();
+
     // Process any incoming messages
-    for (auto iter = PlayerList.begin(); iter != PlayerList.end(); ++iter)
+    for (auto& player : PlayerList)
     {
-        auto& player = *iter;
         if (player.Status != Player::PlayerStatus::Disconnected)
         {
             checkMessages(player);
         }
-        else
-        {
-            PlayerList.erase(iter--);
-        }
     }
 
     if (PlayerList.size() == 0)
@@ -112,7 +110,7 @@ void Server::update()
                 definitions::Projectile projectile;
                 if (player.SpawnProjectile(projectile))
                 {
-                    region.Projectiles.push_front(projectile);
+                    region.AddProjectile(projectile);
                 }
             }
         }
@@ -142,6 +140,29 @@ void Server::update()
     }
 }
 
+void Server::removeDisconnectedPlayers()
+{
+    // Players who dropped before they were given an id never had a slot
+    for (auto& player : PlayerList)
+    {
+        if (player.Status == Player::PlayerStatus::Disconnected && player.Data.id != network::UNASSIGNED_PLAYER_ID)
+        {
+            util::EraseSlot(PlayerSlots, player.Data.id);
+        }
+    }
+
+    std::erase_if(PlayerList, [](Player& player) { return player.Status == Player::PlayerStatus::Disconnected; });
+
+    // Everyone after a removed player has shifted down
+    for (unsigned i = 0; i < PlayerList.size(); ++i)
+    {
+        if (PlayerList[i].Data.id != network::UNASSIGNED_PLAYER_ID)
+        {
+            util::MoveSlot(PlayerSlots, PlayerList[i].Data.id, i);
+        }
+    }
+}
+
 void Server::listen()
 {
     std::shared_ptr<sf::TcpSocket> player_socket(new sf::TcpSocket);
@@ -278,15 +299,21 @@ void Server::startGame()
         // TODO: Magic numbers for distance
         sf::Vector2f spawn_position(50 * std::sin(angle * i), 50 * std::cos(angle * i));
         spawn_position += spawn_point;
-        ServerMessage::AllPlayersLoaded(*PlayerList[i].Socket, spawn_position);
         PlayerList[i].Data.position = spawn_position;
     }
 
     current_region = debug::StartingRegion.value;
 
+    // The region finishes loading, pathing included, before anyone is let in
     region.~Region();
     new(&region)Region(current_zone.regions[current_region].type, PlayerList.size(), STARTING_BATTERY);
 
+    for (auto& player : PlayerList)
+    {
+        player.ClearInvulnerability();
+        ServerMessage::AllPlayersLoaded(*player.Socket, player.Data.position);
+    }
+
     for (unsigned i = 0; i < item_stash.size(); ++i)
     {
         if (i < 6)
@@ -762,7 +789,7 @@ void Server::initLobby(Player& player)
 
     if (ServerMessage::PlayerId(*player.Socket, id))
     {
-        player.Data.id = id;
+        SetPlayerId(player, id);
         owner = player.Data.id;
         cout << "Server initialized by " << player.Data.name << "." << endl;
         player.Status = Player::PlayerStatus::Menus;
@@ -799,7 +826,7 @@ void Server::playerJoined(Player& player)
         return;
     }
 
-    player.Data.id = getPlayerUid();
+    SetPlayerId(player, getPlayerUid());
     std::vector<network::PlayerData> players_in_lobby;
 
     for (auto& p : PlayerList)
@@ -875,6 +902,7 @@ void Server::startLoading(Player& player)
     game_state = GameState::Loading;
 
     current_zone = generateZone();
+    zone_routes = definitions::CreateRouteTable(current_zone);
 
     for (auto& p : PlayerList)
     {
@@ -921,17 +949,11 @@ void Server::loadingComplete(Player& player)
         }
 
         double battery_cost = 0;
-        for (auto& link : current_zone.links)
+        if (util::IsAdjacent(zone_routes, current_region, next_region))
         {
-            if ((link.start == current_region && link.finish == next_region) ||
-                (link.finish == current_region && link.start == next_region))
-            {
-                battery_cost = link.distance;
-                break;
-            }
+            battery_cost = util::GetLinkCost(zone_routes, current_region, next_region);
         }
-
-        if (battery_cost == 0)
+        else
         {
             cerr << "Moved to a region not adjacent." << endl;
         }
@@ -950,6 +972,11 @@ void Server::loadingComplete(Player& player)
             {
                 region.~Region();
                 new(&region)Region(node.type, PlayerList.size(), region.BatteryLevel - battery_cost);
+                for (auto& p : PlayerList)
+                {
+                    p.ClearInvulnerability();
+                }
+
                 break;
             }
         }
@@ -1145,9 +1172,9 @@ void Server::broadcastStates()
         player_list.push_back(player.Data);
     }
 
-    for (auto& enemy : region.Enemies)
+    for (unsigned i = 0; i < region.EnemyStates.Size(); ++i)
     {
-        enemy_list.push_back(enemy.GetData());
+        enemy_list.push_back(region.EnemyStates.GetData(i));
     }
 
     for (auto& projectile : region.Projectiles)
@@ -7,34 +7,44 @@
  *
  *************************************************************************************************/
 #include "util.h"
+#include "global_state.h"
 
 namespace server
 {
 
-Enemy& GetEnemyById(uint16_t id, std::list<Enemy>& enemies)
+using global::PlayerList, global::PlayerSlots;
+
+Player& GetPlayerById(uint16_t id)
 {
-    for (auto& enemy : enemies)
+    unsigned index = util::FindSlot(PlayerSlots, id);
+    if (index == util::SLOT_NOT_FOUND)
     {
-        if (enemy.GetData().id == id)
-        {
-            return enemy;
-        }
+        throw std::runtime_error("Player Id not found: " + std::to_string(id));
     }
 
-    throw std::runtime_error("Enemy Id not found.");
+    return PlayerList[index];
 }
 
-Player& GetPlayerById(uint16_t id, std::vector<Player>& players)
+Player* FindPlayer(util::SlotHandle handle)
 {
-    for (auto& player : players)
+    unsigned index = util::FindSlot(PlayerSlots, handle);
+    if (index == util::SLOT_NOT_FOUND)
     {
-        if (player.Data.id == id)
-        {
-            return player;
-        }
+        return nullptr;
     }
 
-    throw std::runtime_error("Player Id not found: " + std::to_string(id));
+    return &PlayerList[index];
+}
+
+util::SlotHandle GetPlayerHandle(uint16_t id)
+{
+    return util::GetSlotHandle(PlayerSlots, id);
+}
+
+void SetPlayerId(Player& player, uint16_t id)
+{
+    player.Data.id = id;
+    util::InsertSlot(PlayerSlots, id, static_cast<unsigned>(&player - PlayerList.data()));
 }
 
 } // namespace server
@@ -0,0 +1,25 @@
+/**************************************************************************************************
+ *  File:       definitions_packer.cpp
+ *  Library:    DefinitionsPacker
+ *
+ *  Purpose:    Compiles every JSON definition and spritesheet into the binary definitions pack
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "definitions_pack.h"
+#include <iostream>
+
+using std::cout, std::cerr, std::endl;
+
+int main()
+{
+    if (!definitions::BuildDefinitionsPack())
+    {
+        cerr << "Failed to build the definitions pack." << endl;
+        return 1;
+    }
+
+    cout << "Packed definitions into " << definitions::GetDefinitionsPackPath() << endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**************************************************************************************************
+ *  File:       pathing_baker.cpp
+ *  Library:    PathingBaker
+ *
+ *  Purpose:    Precomputes the pathing graph of every region for every enemy size
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "baked_pathing.h"
+#include "obstacle_grid.h"
+#include "definitions.h"
+#include "animation_tracker.h"
+#include <iostream>
+#include <set>
+
+using std::cout, std::cerr, std::endl;
+
+namespace {
+    constexpr float OBSTACLE_CELL_SIZE = 100;
+}
+
+int main()
+{
+    std::filesystem::path directory = util::GetBakedGraphPath(0).parent_path();
+    std::filesystem::create_directories(directory);
+
+    // Blobs are named by the hash of their inputs, so anything not rewritten below is stale
+    for (const auto& entry : std::filesystem::directory_iterator(directory))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".bin")
+        {
+            std::filesystem::remove(entry.path());
+        }
+    }
+
+    std::set<uint64_t> baked;
+    bool success = true;
+
+    for (auto& region : definitions::GetAllRegionDefinitions())
+    {
+        std::vector<sf::FloatRect> obstacles = region.GetCollisions();
+        util::ObstacleGrid grid = util::CreateObstacleGrid(obstacles, OBSTACLE_CELL_SIZE);
+
+        // The same types Region::precomputePathing prepares, so a spawn never has to generate a graph
+        for (auto type : definitions::GetSpawnableEnemyTypes(region))
+        {
+            sf::Vector2f pathing_size = definitions::AnimationTracker::ConstructAnimationTracker(type).GetAnimation("Move").collision_dimensions;
+            uint64_t source_hash = util::HashPathingSource(obstacles, pathing_size);
+
+            if (!baked.insert(source_hash).second)
+            {
+                continue;
+            }
+
+            util::PathingGraph graph = util::CreatePathingGraph(grid, pathing_size);
+            std::filesystem::path path = util::GetBakedGraphPath(source_hash);
+
+            if (!util::SavePathingGraph(path, graph, source_hash))
+            {
+                success = false;
+                continue;
+            }
+
+            cout << path.filename().string() << ": " << graph.nodes.size() << " nodes, " << graph.edges.size() / 2 << " edges" << endl;
+        }
+    }
+
+    cout << "Baked " << baked.size() << " pathing graphs into " << directory << endl;
+
+    return success ? 0 : 1;
+}
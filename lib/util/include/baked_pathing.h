@@ -0,0 +1,28 @@
+/**************************************************************************************************
+ *  File:       baked_pathing.h
+ *
+ *  Purpose:    Pathing graphs precomputed offline and loaded straight from disk
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "pathfinding.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace util
+{
+
+// Identifies the exact inputs a graph was built from. Blobs are named after it, so editing a region simply misses
+uint64_t HashPathingSource(const std::vector<sf::FloatRect>& obstacles, sf::Vector2f entity_size);
+std::filesystem::path GetBakedGraphPath(uint64_t source_hash);
+
+bool SavePathingGraph(const std::filesystem::path& path, const PathingGraph& graph, uint64_t source_hash);
+
+// Returns false if the blob is missing, from another format version, or built from different inputs
+bool LoadPathingGraph(const std::filesystem::path& path, uint64_t source_hash, PathingGraph& out_graph);
+
+} // util
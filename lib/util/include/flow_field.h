@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ *  File:       flow_field.h
+ *
+ *  Purpose:    Goal-centric flow fields shared by every entity heading to the same place
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "SFML/Graphics/Rect.hpp"
+#include "obstacle_grid.h"
+
+namespace util
+{
+
+// A uniform grid over a region. A cell is blocked if an entity of the grid's size centered on it would overlap an obstacle
+struct FlowGrid
+{
+    sf::FloatRect bounds;
+    float cell_size = 0;
+    int columns = 0;
+    int rows = 0;
+    std::vector<uint8_t> blocked;
+};
+
+// Distance to the goal and the next cell along the shortest route for every cell of a grid.
+// Cells that cannot reach the goal have an infinite cost and a next cell of -1
+struct FlowField
+{
+    std::vector<float> costs;
+    std::vector<int> next;
+};
+
+FlowGrid CreateFlowGrid(const ObstacleGrid& obstacles, sf::FloatRect bounds, sf::Vector2f entity_size, float cell_size);
+void BuildFlowField(const FlowGrid& grid, sf::FloatRect goal_area, FlowField& field);
+
+int GetFlowCell(const FlowGrid& grid, sf::Vector2f position);
+float GetFlowCost(const FlowGrid& grid, const FlowField& field, sf::Vector2f position);
+// The farthest of the next lookahead cells along the field that is in line of sight of the entity
+sf::Vector2f GetFlowWaypoint(const FlowGrid& grid, const FlowField& field, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, sf::Vector2f position, unsigned lookahead);
+
+} // util
@@ -76,6 +76,7 @@ namespace util
     bool Intersects(sf::FloatRect rect, LineSegment line);
     bool Intersects(sf::FloatRect rect1, sf::FloatRect rect2);
     bool IntersectionPoint(sf::FloatRect rect, LineVector line, sf::Vector2f& out_intersection_point);
+    bool IntersectionFraction(sf::FloatRect rect, LineSegment line, float& out_fraction); // How far along the line it enters the rect, 0 to 1
     double Distance(sf::Vector2f p1, sf::Vector2f p2);
     sf::Vector2f Normalize(sf::Vector2f vector);
     util::AngleDegrees ToDegrees(util::AngleRadians angle);
@@ -0,0 +1,42 @@
+/**************************************************************************************************
+ *  File:       id_allocator.h
+ *
+ *  Purpose:    Hands out entity ids that are reused once freed
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+
+// An id is a slot in its low ID_SLOT_BITS and that slot's generation in the rest, so it still fits the uint16_t the
+// protocol sends. Freed slots are handed out again oldest first, each time under the next generation.
+//
+// With only 2 generation bits, an id comes back after its slot has been reused 4 times, so the generation does not
+// keep clients from confusing two entities. What does is the order of the TCP stream: an enemy's RemoveEnemy is sent
+// before its id is freed, and projectiles are resent in full every tick, so every client has dropped the old entity
+// before the id can name a new one
+constexpr unsigned ID_SLOT_BITS = 14;
+constexpr unsigned ID_SLOT_COUNT = 1u << ID_SLOT_BITS;
+
+struct IdAllocator
+{
+    std::vector<uint8_t> generations; // By slot
+    std::vector<uint16_t> free_slots; // A ring holding every freed slot, the oldest at free_head
+    unsigned free_head = 0;
+    unsigned free_count = 0;
+    unsigned next_slot = 0; // Slots from here on have never been handed out
+};
+
+// Everything is allocated up front, so allocating and freeing ids never touches the heap
+IdAllocator CreateIdAllocator();
+
+bool AllocateId(IdAllocator& allocator, uint16_t& out_id); // False once every slot is in use
+void FreeId(IdAllocator& allocator, uint16_t id);
+
+} // util
@@ -0,0 +1,38 @@
+/**************************************************************************************************
+ *  File:       invulnerability_table.h
+ *
+ *  Purpose:    Which attackers an entity is still invulnerable to, as the time each one's window expires
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "game_math.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+
+constexpr unsigned INVULNERABILITY_CAPACITY = 8;
+
+// Expiry times are on the region's clock, so nothing needs to count down between hits. Entries are stored inline
+// and reused once expired. An active entry is never dropped: once every inline entry is active, further attackers
+// spill into the overflow, which only a horde piling onto one entity should ever reach
+struct InvulnerabilityTable
+{
+    std::array<uint16_t, INVULNERABILITY_CAPACITY> sources{};
+    std::array<Seconds, INVULNERABILITY_CAPACITY> expiries{};
+    unsigned count = 0;
+
+    std::vector<uint16_t> overflow_sources;
+    std::vector<Seconds> overflow_expiries;
+};
+
+bool IsInvulnerable(const InvulnerabilityTable& table, uint16_t source, Seconds now);
+void AddInvulnerability(InvulnerabilityTable& table, uint16_t source, Seconds expiry, Seconds now);
+void ClearInvulnerability(InvulnerabilityTable& table); // For when the clock the expiries were set against restarts
+
+} // util
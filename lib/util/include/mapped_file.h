@@ -0,0 +1,47 @@
+/**************************************************************************************************
+ *  File:       mapped_file.h
+ *  Class:      MappedFile
+ *
+ *  Purpose:    A read-only memory mapping of a whole file
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace util
+{
+
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool IsOpen() const;
+    const uint8_t* Data() const;
+    std::size_t Size() const;
+
+private:
+    void close();
+
+    const uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
+
+} // util
@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ *  File:       obstacle_grid.h
+ *
+ *  Purpose:    A static broadphase over a region's obstacles for collision and line-of-sight queries
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "game_math.h"
+#include "rect_batch.h"
+#include <vector>
+#include "SFML/Graphics/Rect.hpp"
+
+namespace util
+{
+
+// A uniform grid over the obstacles' extents. Every obstacle is listed in each cell it touches, and the obstacles of
+// cell i are cell_obstacles[cell_offsets[i]] to cell_obstacles[cell_offsets[i + 1] - 1]. cell_rects holds a copy of
+// each listed obstacle at the same index, so a cell's obstacles can be tested against a segment in one batch
+struct ObstacleGrid
+{
+    std::vector<sf::FloatRect> obstacles;
+    sf::FloatRect bounds;
+    float cell_size = 0;
+    int columns = 0;
+    int rows = 0;
+    std::vector<unsigned> cell_offsets;
+    std::vector<unsigned> cell_obstacles;
+    RectBatch cell_rects;
+};
+
+ObstacleGrid CreateObstacleGrid(const std::vector<sf::FloatRect>& obstacles, float cell_size);
+
+// Candidate queries fill out_candidates with the sorted, unique indices of every obstacle that could touch the query
+void QueryObstacles(const ObstacleGrid& grid, sf::FloatRect area, std::vector<unsigned>& out_candidates);
+void QueryObstacles(const ObstacleGrid& grid, LineSegment segment, std::vector<unsigned>& out_candidates);
+void QueryObstacles(const ObstacleGrid& grid, sf::Vector2f point, std::vector<unsigned>& out_candidates);
+
+bool Contains(const ObstacleGrid& grid, sf::Vector2f point);
+bool Intersects(const ObstacleGrid& grid, sf::FloatRect rect);
+bool Intersects(const ObstacleGrid& grid, LineSegment segment);
+
+} // util
@@ -11,44 +11,102 @@
 #include <cstdint>
 #include <vector>
 #include <map>
-#include <list>
 #include "SFML/Graphics/Rect.hpp"
+#include "obstacle_grid.h"
 
 namespace util
 {
 
-struct PathingNode
+struct PathingEdge
 {
-    sf::Vector2f position;
-    std::map<int, float> connections;
+    int target;
+    float cost;
+};
+
+// The static visibility graph between obstacle corners, shared by every entity with the same pathing size.
+// Adjacency is stored compressed: the edges of node i are edges[edge_offsets[i]] to edges[edge_offsets[i + 1] - 1]
+struct PathingGraph
+{
+    std::vector<sf::Vector2f> nodes;
+    std::vector<unsigned> edge_offsets;
+    std::vector<PathingEdge> edges;
+    float clearance = 0;
+};
 
+// A node counts as checked or visited only if its stamp matches the query's current generation, so the
+// state never needs to be cleared between searches
+struct PathingNodeState
+{
     float g_cost;
     float h_cost;
     float f_cost;
 
     int parent;
-    bool visited;
-    bool checked;
+    uint32_t checked_generation = 0;
+    uint32_t visited_generation = 0;
 };
 
-struct PathingGraph
+enum class PathStatus
 {
-    std::vector<PathingNode> nodes;
+    Searching,
+    Found,
+    Failed
 };
 
-PathingGraph CreatePathingGraph(std::vector<sf::FloatRect> obstacles, sf::Vector2f entity_size);
-PathingGraph AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, std::vector<sf::FloatRect> obstacles, sf::FloatRect entity_bounds, const PathingGraph& in_graph);
-std::list<sf::Vector2f> GetPath(PathingGraph& graph);
+struct OpenNode
+{
+    float f_cost;
+    int index;
+};
 
-struct DjikstraNode
+// Per-query scratch space layered on top of a PathingGraph. The start and finish nodes are appended after
+// the static nodes, at indices nodes.size() and nodes.size() + 1. Buffers are reused between queries, and a
+// search in progress can be paused and resumed as long as nothing else uses the query in between.
+struct PathingQuery
 {
-    std::map<int, float> connections;
-    bool visited = false;
+    sf::Vector2f start;
+    sf::Vector2f finish;
+    bool direct = false;
 
-    int parent;
-    double cost;
+    std::vector<PathingEdge> start_edges;
+    std::vector<float> finish_costs; // Infinity if the finish is not visible from the node
+
+    std::vector<PathingNodeState> states;
+    std::vector<OpenNode> open_list; // Binary min-heap on f-cost, stale entries are skipped when popped
+    uint32_t generation = 0;
+    unsigned expanded_nodes = 0;
+    unsigned tested_nodes = 0; // Nodes checked for visibility when attaching the start and finish
+    PathStatus status = PathStatus::Failed;
+    std::vector<sf::Vector2f> path;
+
+    std::vector<int> candidate_nodes; // Nodes near the start or finish of a hierarchical query
 };
 
-std::vector<uint16_t> GetPath(std::vector<DjikstraNode> nodes, uint16_t start, uint16_t finish);
+// A PathingGraph split into square clusters, for regions too large for a flat visibility graph. Edges only connect
+// nodes sharing a cluster, and clusters are joined by portal nodes placed along the open stretches of their shared
+// borders. Portals are listed under both of their clusters: the nodes of cluster c are
+// cluster_nodes[cluster_offsets[c]] to cluster_nodes[cluster_offsets[c + 1] - 1]
+struct HierarchicalPathingGraph
+{
+    PathingGraph graph;
+    sf::FloatRect bounds;
+    float cluster_size = 0;
+    int columns = 0;
+    int rows = 0;
+    std::vector<unsigned> cluster_offsets;
+    std::vector<int> cluster_nodes;
+};
+
+bool HasLineOfSight(const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, sf::Vector2f start, sf::Vector2f target);
+PathingGraph CreatePathingGraph(const ObstacleGrid& obstacles, sf::Vector2f entity_size);
+void AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, const PathingGraph& graph, PathingQuery& query);
+void BeginPath(const PathingGraph& graph, PathingQuery& query);
+PathStatus ContinuePath(const PathingGraph& graph, PathingQuery& query, unsigned expansion_budget);
+const std::vector<sf::Vector2f>& GetPath(const PathingGraph& graph, PathingQuery& query);
+
+HierarchicalPathingGraph CreateHierarchicalPathingGraph(const ObstacleGrid& obstacles, sf::FloatRect bounds, sf::Vector2f entity_size, float cluster_size);
+void AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, const HierarchicalPathingGraph& graph, PathingQuery& query);
+PathStatus ContinuePath(const HierarchicalPathingGraph& graph, const ObstacleGrid& obstacles, PathingQuery& query, unsigned expansion_budget);
+const std::vector<sf::Vector2f>& GetPath(const HierarchicalPathingGraph& graph, const ObstacleGrid& obstacles, PathingQuery& query);
 
 } // namespace util
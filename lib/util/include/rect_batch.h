@@ -0,0 +1,36 @@
+/**************************************************************************************************
+ *  File:       rect_batch.h
+ *
+ *  Purpose:    Rectangles stored as coordinate arrays, so one segment can be tested against several at once
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include "game_math.h"
+#include <cstdint>
+#include <vector>
+#include "SFML/Graphics/Rect.hpp"
+
+namespace util
+{
+
+// The edges of rect i are lefts[i], tops[i], rights[i] and bottoms[i]. Right and bottom edges are stored already
+// summed, exactly as Intersects(sf::FloatRect, LineSegment) computes them, so both give the same answers
+struct RectBatch
+{
+    std::vector<float> lefts;
+    std::vector<float> tops;
+    std::vector<float> rights;
+    std::vector<float> bottoms;
+};
+
+void AddRect(RectBatch& batch, sf::FloatRect rect);
+void ClearRects(RectBatch& batch);
+
+// Tests rects first to first + count - 1, 8 at a time with AVX or 4 at a time with SSE when compiled in
+bool IntersectsAny(const RectBatch& batch, unsigned first, unsigned count, LineSegment line);
+void Intersects(const RectBatch& batch, LineSegment line, std::vector<uint8_t>& out_hits);
+
+} // util
@@ -0,0 +1,53 @@
+/**************************************************************************************************
+ *  File:       route_table.h
+ *
+ *  Purpose:    Precomputed shortest routes between every pair of nodes in a small, static graph
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+
+struct RouteLink
+{
+    uint16_t start;
+    uint16_t finish;
+    float cost;
+};
+
+struct RouteEdge
+{
+    uint16_t target;
+    float cost;
+};
+
+// Links are undirected. Adjacency is stored compressed, and the all-pairs tables are indexed [from * node_count + to].
+// Unreachable pairs have an infinite cost and a next hop of -1
+struct RouteTable
+{
+    unsigned node_count = 0;
+    std::vector<unsigned> edge_offsets;
+    std::vector<RouteEdge> edges;
+
+    std::vector<float> link_costs;
+    std::vector<float> route_costs;
+    std::vector<int> next_hops;
+};
+
+RouteTable CreateRouteTable(unsigned node_count, const std::vector<RouteLink>& links);
+
+// Heap-based Dijkstra from a single source over the table's adjacency
+void FindShortestRoutes(const RouteTable& table, uint16_t source, std::vector<float>& out_costs, std::vector<int>& out_first_hops);
+
+bool IsAdjacent(const RouteTable& table, uint16_t start, uint16_t finish);
+float GetLinkCost(const RouteTable& table, uint16_t start, uint16_t finish);
+float GetRouteCost(const RouteTable& table, uint16_t start, uint16_t finish);
+std::vector<uint16_t> GetRoute(const RouteTable& table, uint16_t start, uint16_t finish);
+
+} // util
@@ -0,0 +1,43 @@
+/**************************************************************************************************
+ *  File:       slot_map.h
+ *
+ *  Purpose:    Maps entity ids to their index in a dense array in constant time, with generations so
+ *              a handle to an erased entity is never mistaken for whatever takes its place
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+
+constexpr unsigned SLOT_NOT_FOUND = static_cast<unsigned>(-1);
+
+// Identifies one lifetime of an id. The handle goes stale once the id is erased, even if the id is inserted again
+struct SlotHandle
+{
+    uint16_t id = 0;
+    uint16_t generation = 0;
+};
+
+// Slot i holds the dense index of id i, or SLOT_NOT_FOUND. Erasing an id bumps its generation
+struct SlotMap
+{
+    std::vector<unsigned> indices;
+    std::vector<uint16_t> generations;
+};
+
+SlotHandle InsertSlot(SlotMap& map, uint16_t id, unsigned index);
+void MoveSlot(SlotMap& map, uint16_t id, unsigned index); // For when the dense array is compacted
+void EraseSlot(SlotMap& map, uint16_t id);
+void ClearSlots(SlotMap& map);
+
+unsigned FindSlot(const SlotMap& map, uint16_t id);
+unsigned FindSlot(const SlotMap& map, SlotHandle handle);
+SlotHandle GetSlotHandle(const SlotMap& map, uint16_t id); // The handle to the id's current lifetime
+
+} // util
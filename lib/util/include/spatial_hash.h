@@ -0,0 +1,35 @@
+/**************************************************************************************************
+ *  File:       spatial_hash.h
+ *
+ *  Purpose:    A uniform spatial hash over moving points, for neighbor queries between entities
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#pragma once
+
+#include <vector>
+#include "SFML/Graphics/Rect.hpp"
+
+namespace util
+{
+
+// Points are bucketed by hashing the cell they fall in, so the hash covers any area without knowing its bounds.
+// Unrelated cells can share a bucket, so queries return candidates that still need an exact test. The items of
+// bucket i are items[bucket_offsets[i]] to items[bucket_offsets[i + 1] - 1]
+struct SpatialHash
+{
+    float cell_size = 0;
+    unsigned bucket_mask = 0;
+    std::vector<unsigned> bucket_offsets;
+    std::vector<unsigned> items;
+    std::vector<unsigned> visited_buckets; // Scratch space for queries
+};
+
+// Rebuilds the hash from scratch, item i being points[i]. Buffers are reused between builds
+void BuildSpatialHash(SpatialHash& hash, const std::vector<sf::Vector2f>& points, float cell_size);
+
+// Fills out_items with every item whose point may lie inside the area, each listed once
+void QuerySpatialHash(SpatialHash& hash, sf::FloatRect area, std::vector<unsigned>& out_items);
+
+} // util
@@ -0,0 +1,167 @@
+/**************************************************************************************************
+ *  File:       baked_pathing.cpp
+ *
+ *  Purpose:    Pathing graphs precomputed offline and loaded straight from disk
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "baked_pathing.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using std::cerr, std::endl;
+
+namespace util
+{
+
+namespace {
+
+// Bump whenever the blob layout or anything in CreatePathingGraph that changes its output is modified
+constexpr uint32_t BAKED_GRAPH_VERSION = 1;
+constexpr char BAKED_GRAPH_MAGIC[4] = {'S', 'D', 'P', 'G'};
+const std::filesystem::path BAKED_GRAPH_DIRECTORY = "../data/pathing";
+
+// The blob is the header followed by the nodes, the edge offsets, and the edges, each packed as they are in memory
+struct BakedGraphHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t source_hash;
+    uint32_t node_count;
+    uint32_t edge_count;
+    float clearance;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BakedGraphHeader) == 32);
+static_assert(sizeof(sf::Vector2f) == 2 * sizeof(float));
+static_assert(sizeof(PathingEdge) == sizeof(int) + sizeof(float));
+
+std::size_t blobSize(uint32_t node_count, uint32_t edge_count)
+{
+    return sizeof(BakedGraphHeader) + node_count * sizeof(sf::Vector2f) + (node_count + 1) * sizeof(unsigned) + edge_count * sizeof(PathingEdge);
+}
+
+void hashBytes(uint64_t& hash, const void* bytes, std::size_t count)
+{
+    // FNV-1a
+    const uint8_t* data = static_cast<const uint8_t*>(bytes);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+} // anonymous namespace
+
+uint64_t HashPathingSource(const std::vector<sf::FloatRect>& obstacles, sf::Vector2f entity_size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashBytes(hash, &BAKED_GRAPH_VERSION, sizeof(BAKED_GRAPH_VERSION));
+    hashBytes(hash, &entity_size.x, sizeof(float));
+    hashBytes(hash, &entity_size.y, sizeof(float));
+
+    for (auto& obstacle : obstacles)
+    {
+        float values[4] = {obstacle.left, obstacle.top, obstacle.width, obstacle.height};
+        hashBytes(hash, values, sizeof(values));
+    }
+
+    return hash;
+}
+
+std::filesystem::path GetBakedGraphPath(uint64_t source_hash)
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << source_hash << ".bin";
+    return BAKED_GRAPH_DIRECTORY / name.str();
+}
+
+bool SavePathingGraph(const std::filesystem::path& path, const PathingGraph& graph, uint64_t source_hash)
+{
+    BakedGraphHeader header{};
+    std::memcpy(header.magic, BAKED_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = BAKED_GRAPH_VERSION;
+    header.source_hash = source_hash;
+    header.node_count = graph.nodes.size();
+    header.edge_count = graph.edges.size();
+    header.clearance = graph.clearance;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        cerr << "Could not write pathing graph: " << path << endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(graph.nodes.data()), graph.nodes.size() * sizeof(sf::Vector2f));
+    file.write(reinterpret_cast<const char*>(graph.edge_offsets.data()), graph.edge_offsets.size() * sizeof(unsigned));
+    file.write(reinterpret_cast<const char*>(graph.edges.data()), graph.edges.size() * sizeof(PathingEdge));
+
+    return static_cast<bool>(file);
+}
+
+bool LoadPathingGraph(const std::filesystem::path& path, uint64_t source_hash, PathingGraph& out_graph)
+{
+    MappedFile file(path);
+    if (!file.IsOpen() || file.Size() < sizeof(BakedGraphHeader))
+    {
+        return false;
+    }
+
+    BakedGraphHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    if (std::memcmp(header.magic, BAKED_GRAPH_MAGIC, sizeof(header.magic)) != 0 || header.version != BAKED_GRAPH_VERSION || header.source_hash != source_hash)
+    {
+        return false;
+    }
+
+    if (file.Size() != blobSize(header.node_count, header.edge_count))
+    {
+        cerr << "Baked pathing graph is truncated: " << path << endl;
+        return false;
+    }
+
+    const uint8_t* cursor = file.Data() + sizeof(header);
+
+    out_graph.clearance = header.clearance;
+
+    out_graph.nodes.resize(header.node_count);
+    std::memcpy(out_graph.nodes.data(), cursor, header.node_count * sizeof(sf::Vector2f));
+    cursor += header.node_count * sizeof(sf::Vector2f);
+
+    out_graph.edge_offsets.resize(header.node_count + 1);
+    std::memcpy(out_graph.edge_offsets.data(), cursor, (header.node_count + 1) * sizeof(unsigned));
+    cursor += (header.node_count + 1) * sizeof(unsigned);
+
+    out_graph.edges.resize(header.edge_count);
+    std::memcpy(out_graph.edges.data(), cursor, header.edge_count * sizeof(PathingEdge));
+
+    bool valid_targets = std::all_of(out_graph.edges.begin(), out_graph.edges.end(), [&](const PathingEdge& edge)
+    {
+        return edge.target >= 0 && static_cast<uint32_t>(edge.target) < header.node_count;
+    });
+
+    // A* reads each node's edges straight from these offsets, so they have to run in order from 0 to the edge count
+    bool valid_offsets = std::is_sorted(out_graph.edge_offsets.begin(), out_graph.edge_offsets.end());
+
+    if (out_graph.edge_offsets.front() != 0 || out_graph.edge_offsets.back() != header.edge_count || !valid_offsets || !valid_targets)
+    {
+        cerr << "Baked pathing graph is corrupt: " << path << endl;
+        out_graph = PathingGraph{};
+        return false;
+    }
+
+    return true;
+}
+
+} // util
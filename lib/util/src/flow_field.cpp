@@ -0,0 +1,246 @@
+/**************************************************************************************************
+ *  File:       flow_field.cpp
+ *
+ *  Purpose:    Goal-centric flow fields shared by every entity heading to the same place
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "flow_field.h"
+#include "game_math.h"
+#include "pathfinding.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace util
+{
+
+namespace {
+
+struct Neighbor
+{
+    int dx;
+    int dy;
+    float cost;
+};
+
+constexpr std::array<Neighbor, 8> NEIGHBORS = {{
+    { 1,  0, 1}, {-1,  0, 1}, { 0,  1, 1}, { 0, -1, 1},
+    { 1,  1, sqrt_2}, { 1, -1, sqrt_2}, {-1,  1, sqrt_2}, {-1, -1, sqrt_2}
+}};
+
+struct OpenCell
+{
+    float cost;
+    int index;
+};
+
+sf::Vector2f cellCenter(const FlowGrid& grid, int index)
+{
+    int column = index % grid.columns;
+    int row = index / grid.columns;
+    return sf::Vector2f{grid.bounds.left + (column + 0.5f) * grid.cell_size, grid.bounds.top + (row + 0.5f) * grid.cell_size};
+}
+
+// Returns the neighboring cell index, or -1 if the step leaves the grid or cuts the corner of a blocked cell
+int stepCell(const FlowGrid& grid, int index, const Neighbor& neighbor)
+{
+    int column = index % grid.columns + neighbor.dx;
+    int row = index / grid.columns + neighbor.dy;
+
+    if (column < 0 || row < 0 || column >= grid.columns || row >= grid.rows)
+    {
+        return -1;
+    }
+
+    if (neighbor.dx != 0 && neighbor.dy != 0)
+    {
+        if (grid.blocked[index + neighbor.dx] || grid.blocked[index + neighbor.dy * grid.columns])
+        {
+            return -1;
+        }
+    }
+
+    return row * grid.columns + column;
+}
+
+// Entities can end up in blocked cells when they brush against obstacles, so fall back to the best reachable neighbor
+int resolveCell(const FlowGrid& grid, const FlowField& field, sf::Vector2f position)
+{
+    int cell = GetFlowCell(grid, position);
+    if (cell < 0 || field.costs.empty() || std::isfinite(field.costs[cell]))
+    {
+        return cell;
+    }
+
+    int best_cell = -1;
+    float best_cost = std::numeric_limits<float>::infinity();
+
+    for (auto& neighbor : NEIGHBORS)
+    {
+        int column = cell % grid.columns + neighbor.dx;
+        int row = cell / grid.columns + neighbor.dy;
+        if (column < 0 || row < 0 || column >= grid.columns || row >= grid.rows)
+        {
+            continue;
+        }
+
+        int index = row * grid.columns + column;
+        if (field.costs[index] + neighbor.cost < best_cost)
+        {
+            best_cost = field.costs[index] + neighbor.cost;
+            best_cell = index;
+        }
+    }
+
+    return best_cell;
+}
+
+} // anonymous namespace
+
+FlowGrid CreateFlowGrid(const ObstacleGrid& obstacles, sf::FloatRect bounds, sf::Vector2f entity_size, float cell_size)
+{
+    FlowGrid grid;
+    grid.bounds = bounds;
+    grid.cell_size = cell_size;
+    grid.columns = std::max(1, static_cast<int>(std::ceil(bounds.width / cell_size)));
+    grid.rows = std::max(1, static_cast<int>(std::ceil(bounds.height / cell_size)));
+    grid.blocked.assign(grid.columns * grid.rows, 0);
+
+    for (int i = 0; i < grid.columns * grid.rows; ++i)
+    {
+        sf::Vector2f center = cellCenter(grid, i);
+        sf::FloatRect entity_bounds{center - entity_size / 2.0f, entity_size};
+
+        if (Intersects(obstacles, entity_bounds))
+        {
+            grid.blocked[i] = 1;
+        }
+    }
+
+    return grid;
+}
+
+void BuildFlowField(const FlowGrid& grid, sf::FloatRect goal_area, FlowField& field)
+{
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    auto compare = [](const OpenCell& lhs, const OpenCell& rhs) { return lhs.cost > rhs.cost; };
+
+    field.costs.assign(grid.columns * grid.rows, infinity);
+    field.next.assign(grid.columns * grid.rows, -1);
+
+    std::vector<OpenCell> open_list;
+
+    for (int i = 0; i < grid.columns * grid.rows; ++i)
+    {
+        if (!grid.blocked[i] && Contains(goal_area, cellCenter(grid, i)))
+        {
+            field.costs[i] = 0;
+            open_list.push_back(OpenCell{0, i});
+        }
+    }
+
+    // A goal smaller than a cell, or one hugging an obstacle, still needs a seed
+    if (open_list.empty())
+    {
+        int goal_cell = GetFlowCell(grid, sf::Vector2f{goal_area.left + goal_area.width / 2, goal_area.top + goal_area.height / 2});
+        if (goal_cell < 0)
+        {
+            return;
+        }
+
+        field.costs[goal_cell] = 0;
+        open_list.push_back(OpenCell{0, goal_cell});
+    }
+
+    while (!open_list.empty())
+    {
+        std::pop_heap(open_list.begin(), open_list.end(), compare);
+        OpenCell current = open_list.back();
+        open_list.pop_back();
+
+        if (current.cost > field.costs[current.index])
+        {
+            continue;
+        }
+
+        for (auto& neighbor : NEIGHBORS)
+        {
+            int index = stepCell(grid, current.index, neighbor);
+            if (index < 0 || grid.blocked[index])
+            {
+                continue;
+            }
+
+            float cost = current.cost + neighbor.cost;
+            if (cost < field.costs[index])
+            {
+                field.costs[index] = cost;
+                field.next[index] = current.index;
+                open_list.push_back(OpenCell{cost, index});
+                std::push_heap(open_list.begin(), open_list.end(), compare);
+            }
+        }
+    }
+}
+
+int GetFlowCell(const FlowGrid& grid, sf::Vector2f position)
+{
+    if (!Contains(grid.bounds, position))
+    {
+        return -1;
+    }
+
+    int column = std::min(static_cast<int>((position.x - grid.bounds.left) / grid.cell_size), grid.columns - 1);
+    int row = std::min(static_cast<int>((position.y - grid.bounds.top) / grid.cell_size), grid.rows - 1);
+
+    return row * grid.columns + column;
+}
+
+float GetFlowCost(const FlowGrid& grid, const FlowField& field, sf::Vector2f position)
+{
+    int cell = resolveCell(grid, field, position);
+    if (cell < 0 || field.costs.empty())
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return field.costs[cell] * grid.cell_size;
+}
+
+sf::Vector2f GetFlowWaypoint(const FlowGrid& grid, const FlowField& field, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, sf::Vector2f position, unsigned lookahead)
+{
+    int start = resolveCell(grid, field, position);
+    if (start < 0 || field.costs.empty() || !std::isfinite(field.costs[start]))
+    {
+        return position;
+    }
+
+    auto advance = [&](unsigned steps)
+    {
+        int cell = start;
+        for (unsigned i = 0; i < steps && field.next[cell] >= 0; ++i)
+        {
+            cell = field.next[cell];
+        }
+
+        return cell;
+    };
+
+    // Where the field turns a corner, the cells further along can be behind the obstacle, so the farthest one that
+    // can be walked to in a straight line is used. The next cell is always reachable, since steps never cut corners
+    for (unsigned steps = lookahead; steps > 1; --steps)
+    {
+        sf::Vector2f waypoint = cellCenter(grid, advance(steps));
+        if (HasLineOfSight(obstacles, entity_bounds, position, waypoint))
+        {
+            return waypoint;
+        }
+    }
+
+    return cellCenter(grid, advance(1));
+}
+
+} // util
@@ -8,6 +8,7 @@
  *************************************************************************************************/
 
 #include "game_math.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
 #include <ctime>
@@ -254,6 +255,41 @@ bool IntersectionPoint(sf::FloatRect rect, LineVector line, sf::Vector2f& out_in
     return false;
 }
 
+bool IntersectionFraction(sf::FloatRect rect, LineSegment line, float& out_fraction)
+{
+    float entry = 0;
+    float exit = 1;
+
+    // Clips the line to the rect one axis at a time. Edges are excluded, as in Contains
+    auto clip = [&](float start, float delta, float low, float high)
+    {
+        if (delta == 0)
+        {
+            return start > low && start < high;
+        }
+
+        float first = (low - start) / delta;
+        float last = (high - start) / delta;
+        if (first > last)
+        {
+            std::swap(first, last);
+        }
+
+        entry = std::max(entry, first);
+        exit = std::min(exit, last);
+        return entry < exit;
+    };
+
+    if (!clip(line.p1.x, line.p2.x - line.p1.x, rect.left, rect.left + rect.width) ||
+        !clip(line.p1.y, line.p2.y - line.p1.y, rect.top, rect.top + rect.height))
+    {
+        return false;
+    }
+
+    out_fraction = entry;
+    return true;
+}
+
 double Distance(sf::Vector2f p1, sf::Vector2f p2)
 {
     sf::Vector2f delta = p2 - p1;
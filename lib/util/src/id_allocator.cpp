@@ -0,0 +1,62 @@
+/**************************************************************************************************
+ *  File:       id_allocator.cpp
+ *
+ *  Purpose:    Hands out entity ids that are reused once freed
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "id_allocator.h"
+
+namespace util
+{
+
+namespace {
+
+constexpr uint16_t SLOT_MASK = ID_SLOT_COUNT - 1;
+constexpr uint8_t GENERATION_MASK = (1u << (16 - ID_SLOT_BITS)) - 1;
+
+} // anonymous namespace
+
+IdAllocator CreateIdAllocator()
+{
+    IdAllocator allocator;
+    allocator.generations.assign(ID_SLOT_COUNT, 0);
+    allocator.free_slots.assign(ID_SLOT_COUNT, 0);
+
+    return allocator;
+}
+
+bool AllocateId(IdAllocator& allocator, uint16_t& out_id)
+{
+    // Fresh slots go first, which leaves freed ones unused for as long as possible
+    unsigned slot;
+    if (allocator.next_slot < ID_SLOT_COUNT)
+    {
+        slot = allocator.next_slot++;
+    }
+    else if (allocator.free_count > 0)
+    {
+        slot = allocator.free_slots[allocator.free_head];
+        allocator.free_head = (allocator.free_head + 1) % ID_SLOT_COUNT;
+        --allocator.free_count;
+    }
+    else
+    {
+        return false;
+    }
+
+    out_id = static_cast<uint16_t>(slot | (allocator.generations[slot] << ID_SLOT_BITS));
+    return true;
+}
+
+void FreeId(IdAllocator& allocator, uint16_t id)
+{
+    uint16_t slot = id & SLOT_MASK;
+    allocator.generations[slot] = (allocator.generations[slot] + 1) & GENERATION_MASK;
+
+    allocator.free_slots[(allocator.free_head + allocator.free_count) % ID_SLOT_COUNT] = slot;
+    ++allocator.free_count;
+}
+
+} // util
@@ -0,0 +1,113 @@
+/**************************************************************************************************
+ *  File:       invulnerability_table.cpp
+ *
+ *  Purpose:    Which attackers an entity is still invulnerable to, as the time each one's window expires
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "invulnerability_table.h"
+
+namespace util
+{
+
+namespace {
+
+constexpr unsigned NOT_FOUND = static_cast<unsigned>(-1);
+
+unsigned findSource(const uint16_t* sources, unsigned count, uint16_t source)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (sources[i] == source)
+        {
+            return i;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+unsigned findExpired(const Seconds* expiries, unsigned count, Seconds now)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (expiries[i] <= now)
+        {
+            return i;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+} // anonymous namespace
+
+bool IsInvulnerable(const InvulnerabilityTable& table, uint16_t source, Seconds now)
+{
+    unsigned slot = findSource(table.sources.data(), table.count, source);
+    if (slot != NOT_FOUND)
+    {
+        return now < table.expiries[slot];
+    }
+
+    slot = findSource(table.overflow_sources.data(), table.overflow_sources.size(), source);
+    if (slot != NOT_FOUND)
+    {
+        return now < table.overflow_expiries[slot];
+    }
+
+    return false;
+}
+
+void AddInvulnerability(InvulnerabilityTable& table, uint16_t source, Seconds expiry, Seconds now)
+{
+    // The source's own entry if it has one, wherever it is, so that no source is ever listed twice
+    unsigned slot = findSource(table.sources.data(), table.count, source);
+    if (slot != NOT_FOUND)
+    {
+        table.expiries[slot] = expiry;
+        return;
+    }
+
+    slot = findSource(table.overflow_sources.data(), table.overflow_sources.size(), source);
+    if (slot != NOT_FOUND)
+    {
+        table.overflow_expiries[slot] = expiry;
+        return;
+    }
+
+    // Otherwise an expired or unused inline entry, then an expired overflow entry, before the overflow grows
+    slot = findExpired(table.expiries.data(), table.count, now);
+    if (slot == NOT_FOUND && table.count < INVULNERABILITY_CAPACITY)
+    {
+        slot = table.count++;
+    }
+
+    if (slot != NOT_FOUND)
+    {
+        table.sources[slot] = source;
+        table.expiries[slot] = expiry;
+        return;
+    }
+
+    slot = findExpired(table.overflow_expiries.data(), table.overflow_expiries.size(), now);
+    if (slot != NOT_FOUND)
+    {
+        table.overflow_sources[slot] = source;
+        table.overflow_expiries[slot] = expiry;
+        return;
+    }
+
+    table.overflow_sources.push_back(source);
+    table.overflow_expiries.push_back(expiry);
+}
+
+void ClearInvulnerability(InvulnerabilityTable& table)
+{
+    table.count = 0;
+    table.overflow_sources.clear();
+    table.overflow_expiries.clear();
+}
+
+} // util
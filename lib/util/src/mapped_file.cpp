@@ -0,0 +1,153 @@
+/**************************************************************************************************
+ *  File:       mapped_file.cpp
+ *  Class:      MappedFile
+ *
+ *  Purpose:    A read-only memory mapping of a whole file
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+
+MappedFile::MappedFile() { }
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+
+    file_handle = file;
+    mapping_handle = mapping;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat file_status;
+    if (fstat(file, &file_status) != 0 || file_status.st_size == 0)
+    {
+        ::close(file);
+        return;
+    }
+
+    void* view = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file); // The mapping keeps the file alive on its own
+
+    if (view == MAP_FAILED)
+    {
+        return;
+    }
+
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<std::size_t>(file_status.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+#ifdef _WIN32
+        file_handle = std::exchange(other.file_handle, nullptr);
+        mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return data != nullptr;
+}
+
+const uint8_t* MappedFile::Data() const
+{
+    return data;
+}
+
+std::size_t MappedFile::Size() const
+{
+    return size;
+}
+
+void MappedFile::close()
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+    file_handle = nullptr;
+    mapping_handle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data), size);
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+} // util
@@ -0,0 +1,259 @@
+/**************************************************************************************************
+ *  File:       obstacle_grid.cpp
+ *
+ *  Purpose:    A static broadphase over a region's obstacles for collision and line-of-sight queries
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "obstacle_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace util
+{
+
+namespace {
+
+// Segments are rasterized conservatively, so a little slack keeps rounding from dropping a cell the segment only grazes
+constexpr float CELL_EPSILON = 0.001f;
+
+struct CellRange
+{
+    int first_column;
+    int last_column;
+    int first_row;
+    int last_row;
+};
+
+int columnOf(const ObstacleGrid& grid, float x)
+{
+    return std::clamp(static_cast<int>(std::floor((x - grid.bounds.left) / grid.cell_size)), 0, grid.columns - 1);
+}
+
+int rowOf(const ObstacleGrid& grid, float y)
+{
+    return std::clamp(static_cast<int>(std::floor((y - grid.bounds.top) / grid.cell_size)), 0, grid.rows - 1);
+}
+
+CellRange cellRange(const ObstacleGrid& grid, sf::FloatRect area)
+{
+    return CellRange{columnOf(grid, area.left), columnOf(grid, area.left + area.width),
+                     rowOf(grid, area.top), rowOf(grid, area.top + area.height)};
+}
+
+// Calls visit(cell_index) for every cell overlapping the area, stopping early if it returns true
+template <typename Visitor>
+bool visitCells(const ObstacleGrid& grid, sf::FloatRect area, Visitor visit)
+{
+    CellRange range = cellRange(grid, area);
+    for (int row = range.first_row; row <= range.last_row; ++row)
+    {
+        for (int column = range.first_column; column <= range.last_column; ++column)
+        {
+            if (visit(row * grid.columns + column))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Calls visit(cell_index) for every cell the segment passes through, stopping early if it returns true
+template <typename Visitor>
+bool visitCells(const ObstacleGrid& grid, LineSegment segment, Visitor visit)
+{
+    float min_y = std::min(segment.p1.y, segment.p2.y);
+    float max_y = std::max(segment.p1.y, segment.p2.y);
+    float dy = segment.p2.y - segment.p1.y;
+    float slack = grid.cell_size * CELL_EPSILON;
+
+    int first_row = rowOf(grid, min_y - slack);
+    int last_row = rowOf(grid, max_y + slack);
+
+    for (int row = first_row; row <= last_row; ++row)
+    {
+        float row_top = grid.bounds.top + row * grid.cell_size;
+        float span_top = (row == first_row) ? min_y : std::max(min_y, row_top);
+        float span_bottom = (row == last_row) ? max_y : std::min(max_y, row_top + grid.cell_size);
+
+        float x1;
+        float x2;
+        if (dy == 0)
+        {
+            x1 = segment.p1.x;
+            x2 = segment.p2.x;
+        }
+        else
+        {
+            x1 = segment.p1.x + (span_top - segment.p1.y) / dy * (segment.p2.x - segment.p1.x);
+            x2 = segment.p1.x + (span_bottom - segment.p1.y) / dy * (segment.p2.x - segment.p1.x);
+        }
+
+        int first_column = columnOf(grid, std::min(x1, x2) - slack);
+        int last_column = columnOf(grid, std::max(x1, x2) + slack);
+
+        for (int column = first_column; column <= last_column; ++column)
+        {
+            if (visit(row * grid.columns + column))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <typename Shape>
+void collectCandidates(const ObstacleGrid& grid, Shape shape, std::vector<unsigned>& out_candidates)
+{
+    out_candidates.clear();
+    if (grid.obstacles.empty())
+    {
+        return;
+    }
+
+    visitCells(grid, shape, [&](int cell)
+    {
+        out_candidates.insert(out_candidates.end(), grid.cell_obstacles.begin() + grid.cell_offsets[cell], grid.cell_obstacles.begin() + grid.cell_offsets[cell + 1]);
+        return false;
+    });
+
+    std::sort(out_candidates.begin(), out_candidates.end());
+    out_candidates.erase(std::unique(out_candidates.begin(), out_candidates.end()), out_candidates.end());
+}
+
+} // anonymous namespace
+
+ObstacleGrid CreateObstacleGrid(const std::vector<sf::FloatRect>& obstacles, float cell_size)
+{
+    ObstacleGrid grid;
+    grid.obstacles = obstacles;
+    grid.cell_size = cell_size;
+
+    if (obstacles.empty())
+    {
+        grid.columns = 1;
+        grid.rows = 1;
+        grid.cell_offsets.assign(2, 0);
+        return grid;
+    }
+
+    float left = obstacles[0].left;
+    float top = obstacles[0].top;
+    float right = obstacles[0].left + obstacles[0].width;
+    float bottom = obstacles[0].top + obstacles[0].height;
+
+    for (auto& obstacle : obstacles)
+    {
+        left = std::min(left, obstacle.left);
+        top = std::min(top, obstacle.top);
+        right = std::max(right, obstacle.left + obstacle.width);
+        bottom = std::max(bottom, obstacle.top + obstacle.height);
+    }
+
+    grid.bounds = sf::FloatRect{left, top, right - left, bottom - top};
+    grid.columns = std::max(1, static_cast<int>(std::ceil(grid.bounds.width / cell_size)));
+    grid.rows = std::max(1, static_cast<int>(std::ceil(grid.bounds.height / cell_size)));
+
+    // Count first, then fill, so every cell's list is contiguous
+    std::vector<unsigned> counts(grid.columns * grid.rows, 0);
+    for (auto& obstacle : obstacles)
+    {
+        visitCells(grid, obstacle, [&](int cell) { ++counts[cell]; return false; });
+    }
+
+    grid.cell_offsets.resize(counts.size() + 1);
+    grid.cell_offsets[0] = 0;
+    for (unsigned i = 0; i < counts.size(); ++i)
+    {
+        grid.cell_offsets[i + 1] = grid.cell_offsets[i] + counts[i];
+    }
+
+    std::vector<unsigned> cursors(grid.cell_offsets.begin(), grid.cell_offsets.end() - 1);
+    grid.cell_obstacles.resize(grid.cell_offsets.back());
+    for (unsigned i = 0; i < obstacles.size(); ++i)
+    {
+        visitCells(grid, obstacles[i], [&](int cell) { grid.cell_obstacles[cursors[cell]++] = i; return false; });
+    }
+
+    for (unsigned index : grid.cell_obstacles)
+    {
+        AddRect(grid.cell_rects, obstacles[index]);
+    }
+
+    return grid;
+}
+
+void QueryObstacles(const ObstacleGrid& grid, sf::FloatRect area, std::vector<unsigned>& out_candidates)
+{
+    collectCandidates(grid, area, out_candidates);
+}
+
+void QueryObstacles(const ObstacleGrid& grid, LineSegment segment, std::vector<unsigned>& out_candidates)
+{
+    collectCandidates(grid, segment, out_candidates);
+}
+
+void QueryObstacles(const ObstacleGrid& grid, sf::Vector2f point, std::vector<unsigned>& out_candidates)
+{
+    collectCandidates(grid, sf::FloatRect{point, sf::Vector2f{0, 0}}, out_candidates);
+}
+
+bool Contains(const ObstacleGrid& grid, sf::Vector2f point)
+{
+    if (grid.obstacles.empty())
+    {
+        return false;
+    }
+
+    int cell = rowOf(grid, point.y) * grid.columns + columnOf(grid, point.x);
+    for (unsigned i = grid.cell_offsets[cell]; i < grid.cell_offsets[cell + 1]; ++i)
+    {
+        if (Contains(grid.obstacles[grid.cell_obstacles[i]], point))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Intersects(const ObstacleGrid& grid, sf::FloatRect rect)
+{
+    if (grid.obstacles.empty())
+    {
+        return false;
+    }
+
+    return visitCells(grid, rect, [&](int cell)
+    {
+        for (unsigned i = grid.cell_offsets[cell]; i < grid.cell_offsets[cell + 1]; ++i)
+        {
+            if (Intersects(grid.obstacles[grid.cell_obstacles[i]], rect))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    });
+}
+
+bool Intersects(const ObstacleGrid& grid, LineSegment segment)
+{
+    if (grid.obstacles.empty())
+    {
+        return false;
+    }
+
+    return visitCells(grid, segment, [&](int cell)
+    {
+        return IntersectsAny(grid.cell_rects, grid.cell_offsets[cell], grid.cell_offsets[cell + 1] - grid.cell_offsets[cell], segment);
+    });
+}
+
+} // util
@@ -9,369 +9,715 @@
 
 #include "pathfinding.h"
 #include "game_math.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <thread>
 
 using std::cout, std::cerr, std::endl;
 
 namespace util {
 namespace {
 
-[[maybe_unused]] void printPathingGraph(PathingGraph graph)
+[[maybe_unused]] void printPathingGraph(const PathingGraph& graph)
 {
     for (unsigned i = 0; i < graph.nodes.size(); ++i)
     {
-        cout << "Node " << i << ": X=" << graph.nodes[i].position.x << ", Y=" << graph.nodes[i].position.y << "\n";
-        for (auto& connection : graph.nodes[i].connections)
+        cout << "Node " << i << ": X=" << graph.nodes[i].x << ", Y=" << graph.nodes[i].y << "\n";
+        for (unsigned edge = graph.edge_offsets[i]; edge < graph.edge_offsets[i + 1]; ++edge)
         {
-            cout << "    Connection: " << connection.first << ", Cost: " << connection.second << "\n";
+            cout << "    Connection: " << graph.edges[edge].target << ", Cost: " << graph.edges[edge].cost << "\n";
         }
         cout << endl;
     }
 }
 
-} // anonymous namespace
+constexpr unsigned MIN_NODES_PER_WORKER = 64;
+constexpr unsigned PORTALS_PER_BORDER = 2; // Upper bound for a fully open border, so paths are not pinched through one point
+bool lowestCost(const OpenNode& lhs, const OpenNode& rhs)
+{
+    return lhs.f_cost > rhs.f_cost;
+}
+
+constexpr unsigned REFINE_WINDOW = 8; // Waypoints considered for shortcuts when smoothing a hierarchical path
 
-PathingGraph CreatePathingGraph(std::vector<sf::FloatRect> obstacles, sf::Vector2f entity_size)
+bool hasLineOfSight(const ObstacleGrid& obstacles, LineSegment left_bound, LineSegment right_bound)
 {
-    PathingGraph graph;
+    return !Intersects(obstacles, left_bound) && !Intersects(obstacles, right_bound);
+}
 
-    // Create two blank nodes for start and finish later
-    graph.nodes.push_back(PathingNode{});
-    graph.nodes.push_back(PathingNode{});
+bool hasLineOfSight(const ObstacleGrid& obstacles, sf::Vector2f p1, sf::Vector2f p2, float sight_width)
+{
+    sf::Vector2f path_vector = p2 - p1;
+    float length = std::hypot(path_vector.x, path_vector.y);
+    sf::Vector2f left_orthogonal{-path_vector.y / length * sight_width, path_vector.x / length * sight_width};
+    sf::Vector2f right_orthogonal{path_vector.y / length * sight_width, -path_vector.x / length * sight_width};
 
-    float clearance = (std::max(entity_size.x, entity_size.y) / 2) * 1.25f;
+    LineSegment left_bound{p1 + left_orthogonal, p2 + left_orthogonal};
+    LineSegment right_bound{p1 + right_orthogonal, p2 + right_orthogonal};
 
-    for (auto& rect : obstacles)
+    return hasLineOfSight(obstacles, left_bound, right_bound);
+}
+
+std::vector<sf::Vector2f> createCornerNodes(const ObstacleGrid& obstacles, float clearance)
+{
+    std::vector<sf::Vector2f> nodes;
+
+    for (auto& rect : obstacles.obstacles)
     {
         bool collides = false;
 
-        PathingNode upper_left{};
-        upper_left.position = sf::Vector2f{rect.left - clearance, rect.top - clearance};
-        for (auto& obstacle : obstacles)
+        sf::Vector2f upper_left{rect.left - clearance, rect.top - clearance};
+        if (Contains(obstacles, upper_left))
         {
-            if (util::Contains(obstacle, upper_left.position))
-            {
-                collides = true;
-                break;
-            }
+            collides = true;
         }
 
         if (!collides)
         {
-            graph.nodes.push_back(upper_left);
+            nodes.push_back(upper_left);
         }
 
-        PathingNode upper_right{};
-        upper_right.position = sf::Vector2f{rect.left + rect.width + clearance, rect.top - clearance};
-        for (auto& obstacle : obstacles)
+        sf::Vector2f upper_right{rect.left + rect.width + clearance, rect.top - clearance};
+        if (Contains(obstacles, upper_right))
         {
-            if (util::Contains(obstacle, upper_right.position))
-            {
-                collides = true;
-                break;
-            }
+            collides = true;
         }
 
         if (!collides)
         {
-            graph.nodes.push_back(upper_right);
+            nodes.push_back(upper_right);
         }
 
-        PathingNode lower_left{};
-        lower_left.position = sf::Vector2f{rect.left - clearance, rect.top + rect.height + clearance};
-        for (auto& obstacle : obstacles)
+        sf::Vector2f lower_left{rect.left - clearance, rect.top + rect.height + clearance};
+        if (Contains(obstacles, lower_left))
         {
-            if (util::Contains(obstacle, lower_left.position))
-            {
-                collides = true;
-                break;
-            }
+            collides = true;
         }
 
         if (!collides)
         {
-            graph.nodes.push_back(lower_left);
+            nodes.push_back(lower_left);
         }
 
-        PathingNode lower_right{};
-        lower_right.position = sf::Vector2f{rect.left + rect.width + clearance, rect.top + rect.height + clearance};
-        for (auto& obstacle : obstacles)
+        sf::Vector2f lower_right{rect.left + rect.width + clearance, rect.top + rect.height + clearance};
+        if (Contains(obstacles, lower_right))
         {
-            if (util::Contains(obstacle, lower_right.position))
-            {
-                collides = true;
-                break;
-            }
+            collides = true;
         }
 
         if (!collides)
         {
-            graph.nodes.push_back(lower_right);
+            nodes.push_back(lower_right);
         }
     }
 
-    float sight_width = clearance - 1;
+    return nodes;
+}
+
+// Hands out tasks one at a time, so uneven tasks still balance across the workers
+template <typename Task>
+void runTasks(unsigned task_count, unsigned min_tasks_per_worker, Task task)
+{
+    std::atomic<unsigned> next_task{0};
 
-    for (unsigned i = 2; i < graph.nodes.size() - 1; ++i)
+    auto worker_loop = [&]()
     {
-        PathingNode& current_node = graph.nodes[i];
-        for (unsigned j = i + 1; j < graph.nodes.size(); ++j)
+        for (unsigned i = next_task++; i < task_count; i = next_task++)
         {
-            PathingNode& other_node = graph.nodes[j];
+            task(i);
+        }
+    };
+
+    unsigned worker_count = std::min<unsigned>(std::max(1u, std::thread::hardware_concurrency()), task_count / min_tasks_per_worker + 1);
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < worker_count; ++i)
+    {
+        workers.emplace_back(worker_loop);
+    }
 
-            sf::Vector2f path_vector = other_node.position - current_node.position;
-            float length = std::hypot(path_vector.x, path_vector.y);
-            sf::Vector2f left_orthogonal{-path_vector.y / length * sight_width, path_vector.x / length * sight_width};
-            sf::Vector2f right_orthogonal{path_vector.y / length * sight_width, -path_vector.x / length * sight_width};
+    worker_loop();
 
-            LineSegment left_bound{current_node.position + left_orthogonal, other_node.position + left_orthogonal};
-            LineSegment right_bound{current_node.position + right_orthogonal, other_node.position + right_orthogonal};
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
 
-            bool line_of_sight = true;
-            for (auto& rect : obstacles)
-            {
-                if (Intersects(rect, left_bound))
-                {
-                    line_of_sight = false;
-                    break;
-                }
+// Packs visible pairs (i < j, sorted ascending) into the compressed adjacency layout
+void packEdges(PathingGraph& graph, const std::vector<std::pair<int, int>>& connections)
+{
+    std::vector<unsigned> degrees(graph.nodes.size(), 0);
+    for (auto& [i, j] : connections)
+    {
+        ++degrees[i];
+        ++degrees[j];
+    }
 
-                if (Intersects(rect, right_bound))
-                {
-                    line_of_sight = false;
-                    break;
-                }
+    graph.edge_offsets.resize(graph.nodes.size() + 1);
+    graph.edge_offsets[0] = 0;
+    for (unsigned i = 0; i < graph.nodes.size(); ++i)
+    {
+        graph.edge_offsets[i + 1] = graph.edge_offsets[i] + degrees[i];
+    }
+
+    // Pairs arrive in ascending order, so each node's edges end up sorted by target
+    std::vector<unsigned> cursors(graph.edge_offsets.begin(), graph.edge_offsets.end() - 1);
+    graph.edges.resize(connections.size() * 2);
+    for (auto& [i, j] : connections)
+    {
+        float distance = Distance(graph.nodes[i], graph.nodes[j]);
+        graph.edges[cursors[i]++] = PathingEdge{j, distance};
+        graph.edges[cursors[j]++] = PathingEdge{i, distance};
+    }
+}
+
+int getCluster(const HierarchicalPathingGraph& graph, sf::Vector2f point)
+{
+    int column = std::clamp(static_cast<int>(std::floor((point.x - graph.bounds.left) / graph.cluster_size)), 0, graph.columns - 1);
+    int row = std::clamp(static_cast<int>(std::floor((point.y - graph.bounds.top) / graph.cluster_size)), 0, graph.rows - 1);
+
+    return row * graph.columns + column;
+}
+
+// Places portals at the middle of each open stretch of a border, where an entity centered on the border line fits
+void addBorderPortals(const ObstacleGrid& obstacles, sf::Vector2f border_start, sf::Vector2f border_direction, float border_length, float clearance, std::vector<sf::Vector2f>& out_portals)
+{
+    float sample_spacing = std::max(clearance, 1.0f);
+    float max_span = border_length / PORTALS_PER_BORDER;
+    unsigned sample_count = static_cast<unsigned>(border_length / sample_spacing) + 1;
+
+    auto add_run = [&](float run_start, float run_end)
+    {
+        unsigned pieces = std::max(1u, static_cast<unsigned>(std::ceil((run_end - run_start) / max_span)));
+        float piece_length = (run_end - run_start) / pieces;
+        for (unsigned i = 0; i < pieces; ++i)
+        {
+            out_portals.push_back(border_start + border_direction * (run_start + piece_length * (i + 0.5f)));
+        }
+    };
+
+    bool in_run = false;
+    float run_start = 0;
+    float run_end = 0;
+
+    for (unsigned i = 0; i < sample_count; ++i)
+    {
+        float offset = std::min(i * sample_spacing, border_length);
+        sf::Vector2f sample = border_start + border_direction * offset;
+        bool open = !Intersects(obstacles, sf::FloatRect{sample.x - clearance, sample.y - clearance, clearance * 2, clearance * 2});
+
+        if (open)
+        {
+            if (!in_run)
+            {
+                run_start = offset;
+                in_run = true;
             }
 
-            if (line_of_sight)
+            run_end = offset;
+        }
+        else if (in_run)
+        {
+            add_run(run_start, run_end);
+            in_run = false;
+        }
+    }
+
+    if (in_run)
+    {
+        add_run(run_start, run_end);
+    }
+}
+
+// Collects the nodes of the point's cluster, or of the surrounding clusters as well if radius is 1
+void gatherClusterNodes(const HierarchicalPathingGraph& graph, sf::Vector2f point, int radius, std::vector<int>& out_nodes)
+{
+    out_nodes.clear();
+
+    int cluster = getCluster(graph, point);
+    int column = cluster % graph.columns;
+    int row = cluster / graph.columns;
+
+    for (int r = std::max(0, row - radius); r <= std::min(graph.rows - 1, row + radius); ++r)
+    {
+        for (int c = std::max(0, column - radius); c <= std::min(graph.columns - 1, column + radius); ++c)
+        {
+            int index = r * graph.columns + c;
+            out_nodes.insert(out_nodes.end(), graph.cluster_nodes.begin() + graph.cluster_offsets[index], graph.cluster_nodes.begin() + graph.cluster_offsets[index + 1]);
+        }
+    }
+
+    // Portals belong to two clusters
+    std::sort(out_nodes.begin(), out_nodes.end());
+    out_nodes.erase(std::unique(out_nodes.begin(), out_nodes.end()), out_nodes.end());
+}
+
+} // anonymous namespace
+
+PathingGraph CreatePathingGraph(const ObstacleGrid& obstacles, sf::Vector2f entity_size)
+{
+    PathingGraph graph;
+
+    float clearance = (std::max(entity_size.x, entity_size.y) / 2) * 1.25f;
+    graph.clearance = clearance;
+    graph.nodes = createCornerNodes(obstacles, clearance);
+
+    float sight_width = clearance - 1;
+
+    // Gather the visible pairs first, then pack them into the compressed adjacency layout.
+    // Each row i only tests the nodes after it, so rows are handed out one at a time to balance the triangle across workers
+    std::vector<std::vector<int>> visible(graph.nodes.size());
+
+    runTasks(graph.nodes.size(), MIN_NODES_PER_WORKER, [&](unsigned i)
+    {
+        for (unsigned j = i + 1; j < graph.nodes.size(); ++j)
+        {
+            if (hasLineOfSight(obstacles, graph.nodes[i], graph.nodes[j], sight_width))
             {
-                float distance = Distance(current_node.position, other_node.position);
-                current_node.connections[j] = distance;
-                other_node.connections[i] = distance;
+                visible[i].push_back(j);
             }
         }
+    });
+
+    std::vector<std::pair<int, int>> connections;
+    for (unsigned i = 0; i < graph.nodes.size(); ++i)
+    {
+        for (int j : visible[i])
+        {
+            connections.push_back({i, j});
+        }
     }
 
+    packEdges(graph, connections);
+
     return graph;
 }
 
-PathingGraph AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, std::vector<sf::FloatRect> obstacles, sf::FloatRect entity_bounds, const PathingGraph& in_graph)
+bool HasLineOfSight(const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, sf::Vector2f start, sf::Vector2f target)
 {
-    PathingGraph out_graph = in_graph;
+    // Special case for calculating the line of sight from an entity, because we know its exact bounds
+    sf::Vector2f path_vector = target - start;
+    LineSegment left_bound;
+    LineSegment right_bound;
+
+    if ((path_vector.x >= 0 && path_vector.y >= 0) || (path_vector.x < 0 && path_vector.y < 0))
+    {
+        left_bound.p1 = sf::Vector2f{entity_bounds.left, entity_bounds.top}; // upper left corner
+        right_bound.p1 = sf::Vector2f{entity_bounds.left + entity_bounds.width, entity_bounds.top + entity_bounds.height}; // lower right corner
+    }
+    else
+    {
+        left_bound.p1 = sf::Vector2f{entity_bounds.left, entity_bounds.top + entity_bounds.height}; // lower left corner
+        right_bound.p1 = sf::Vector2f{entity_bounds.left + entity_bounds.width, entity_bounds.top}; // upper right corner
+    }
+
+    left_bound.p2 = left_bound.p1 + path_vector;
+    right_bound.p2 = right_bound.p1 + path_vector;
+
+    return hasLineOfSight(obstacles, left_bound, right_bound);
+}
 
-    out_graph.nodes[0].position = start;
-    out_graph.nodes[1].position = finish;
+void AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, const PathingGraph& graph, PathingQuery& query)
+{
+    query.start = start;
+    query.finish = finish;
+    query.start_edges.clear();
+    query.finish_costs.assign(graph.nodes.size(), std::numeric_limits<float>::infinity());
+    query.tested_nodes = graph.nodes.size();
 
     float clearance = (std::max(entity_bounds.width, entity_bounds.height) / 2) * 1.25f;
     float sight_width = clearance - 1;
 
-    for (auto& node : out_graph.nodes)
-    {
-        node.h_cost = Distance(node.position, out_graph.nodes[1].position);
-    }
+    query.direct = HasLineOfSight(obstacles, entity_bounds, start, finish);
 
-    for (unsigned i = 0; i < 2; ++i)
+    for (unsigned i = 0; i < graph.nodes.size(); ++i)
     {
-        PathingNode& current_node = out_graph.nodes[i];
-        for (unsigned j = i + 1; j < out_graph.nodes.size(); ++j)
+        if (HasLineOfSight(obstacles, entity_bounds, start, graph.nodes[i]))
         {
-            PathingNode& other_node = out_graph.nodes[j];
-
-            sf::Vector2f path_vector = other_node.position - current_node.position;
-            float length = std::hypot(path_vector.x, path_vector.y);
-            LineSegment left_bound;
-            LineSegment right_bound;
+            query.start_edges.push_back(PathingEdge{static_cast<int>(i), static_cast<float>(Distance(start, graph.nodes[i]))});
+        }
 
-            if (i == 0)
-            {
-                // Special case for calculating the line of sight, because we know the position of the entity
-                if ((path_vector.x >= 0 && path_vector.y >= 0) || (path_vector.x < 0 && path_vector.y < 0))
-                {
-                    left_bound.p1 = sf::Vector2f{entity_bounds.left, entity_bounds.top}; // upper left corner
-                    right_bound.p1 = sf::Vector2f{entity_bounds.left + entity_bounds.width, entity_bounds.top + entity_bounds.height}; // lower right corner
-                }
-                else
-                {
-                    left_bound.p1 = sf::Vector2f{entity_bounds.left, entity_bounds.top + entity_bounds.height}; // lower left corner
-                    right_bound.p1 = sf::Vector2f{entity_bounds.left + entity_bounds.width, entity_bounds.top}; // upper right corner
-                }
+        if (hasLineOfSight(obstacles, finish, graph.nodes[i], sight_width))
+        {
+            query.finish_costs[i] = Distance(finish, graph.nodes[i]);
+        }
+    }
+}
 
-                left_bound.p2 = left_bound.p1 + path_vector;
-                right_bound.p2 = right_bound.p1 + path_vector;
-            }
-            else
-            {
-                sf::Vector2f left_orthogonal{-path_vector.y / length * sight_width, path_vector.x / length * sight_width};
-                sf::Vector2f right_orthogonal{path_vector.y / length * sight_width, -path_vector.x / length * sight_width};
+void BeginPath(const PathingGraph& graph, PathingQuery& query)
+{
+    query.path.clear();
+    query.open_list.clear();
+    query.expanded_nodes = 0;
 
-                left_bound = LineSegment{current_node.position + left_orthogonal, other_node.position + left_orthogonal};
-                right_bound = LineSegment{current_node.position + right_orthogonal, other_node.position + right_orthogonal};
-            }
+    if (query.direct)
+    {
+        query.path.push_back(query.finish);
+        query.status = PathStatus::Found;
+        return;
+    }
 
-            bool line_of_sight = true;
-            for (auto& rect : obstacles)
-            {
-                if (Intersects(rect, left_bound))
-                {
-                    line_of_sight = false;
-                    break;
-                }
+    const int start_index = graph.nodes.size();
 
-                if (Intersects(rect, right_bound))
-                {
-                    line_of_sight = false;
-                    break;
-                }
-            }
+    if (query.states.size() < graph.nodes.size() + 2)
+    {
+        query.states.resize(graph.nodes.size() + 2);
+    }
 
-            if (line_of_sight)
-            {
-                float distance = Distance(current_node.position, other_node.position);
-                current_node.connections[j] = distance;
-                other_node.connections[i] = distance;
-            }
+    ++query.generation;
+    if (query.generation == 0)
+    {
+        // The stamps wrapped around, so old stamps could alias the new generation
+        for (auto& state : query.states)
+        {
+            state.checked_generation = 0;
+            state.visited_generation = 0;
         }
 
-        current_node.h_cost = Distance(current_node.position, out_graph.nodes[1].position);
+        query.generation = 1;
     }
 
-    return out_graph;
+    PathingNodeState& start_node = query.states[start_index];
+    start_node.checked_generation = query.generation;
+    start_node.g_cost = 0;
+    start_node.h_cost = Distance(query.start, query.finish);
+    start_node.f_cost = start_node.h_cost;
+    query.open_list.push_back(OpenNode{start_node.f_cost, start_index});
+    query.status = PathStatus::Searching;
 }
 
-std::list<sf::Vector2f> GetPath(PathingGraph& graph)
+PathStatus ContinuePath(const PathingGraph& graph, PathingQuery& query, unsigned expansion_budget)
 {
-    std::list<sf::Vector2f> path;
-    std::list<int> open_list;
-
-    if (graph.nodes[0].connections.find(1) != graph.nodes[0].connections.end())
+    if (query.status != PathStatus::Searching)
     {
-        path.push_front(graph.nodes[1].position);
-        return path;
+        return query.status;
     }
 
-    int current_index = 0;
-    PathingNode& start_node = graph.nodes[current_index];
-    start_node.checked = true;
+    const int start_index = graph.nodes.size();
+    const int finish_index = start_index + 1;
+
+    auto position = [&](int index)
+    {
+        if (index == start_index)
+        {
+            return query.start;
+        }
+
+        if (index == finish_index)
+        {
+            return query.finish;
+        }
 
-    open_list.push_back(current_index);
+        return graph.nodes[index];
+    };
 
+    const uint32_t generation = query.generation;
+
+    auto relax = [&](int current_index, int neighbor_index, float cost_from_current)
+    {
+        PathingNodeState& neighbor = query.states[neighbor_index];
+        if (neighbor.visited_generation == generation)
+        {
+            return;
+        }
+
+        float new_g_cost = query.states[current_index].g_cost + cost_from_current;
+
+        if (neighbor.checked_generation != generation)
+        {
+            neighbor.checked_generation = generation;
+            neighbor.h_cost = Distance(position(neighbor_index), query.finish);
+        }
+        else if (neighbor.g_cost <= new_g_cost)
+        {
+            return;
+        }
+
+        neighbor.g_cost = new_g_cost;
+        neighbor.f_cost = new_g_cost + neighbor.h_cost;
+        neighbor.parent = current_index;
+
+        query.open_list.push_back(OpenNode{neighbor.f_cost, neighbor_index});
+        std::push_heap(query.open_list.begin(), query.open_list.end(), lowestCost);
+    };
+
+    int current_index = start_index;
     bool path_found = false;
-    while (true)
+    for (unsigned expanded = 0; !query.open_list.empty(); )
     {
-        if (open_list.empty())
+        if (expanded == expansion_budget)
         {
-            // No path available?
-            cerr << "Cannot find path\n";
-            break;
+            // Out of budget for now, the open list holds everything needed to carry on later
+            return query.status;
         }
 
         // Get node with lowest f-cost from the open list
-        current_index = open_list.front();
-        for (auto index : open_list)
+        std::pop_heap(query.open_list.begin(), query.open_list.end(), lowestCost);
+        OpenNode open_node = query.open_list.back();
+        query.open_list.pop_back();
+
+        PathingNodeState& current = query.states[open_node.index];
+        if (current.visited_generation == generation || open_node.f_cost > current.f_cost)
         {
-            if (graph.nodes[index].f_cost < graph.nodes[current_index].f_cost)
-            {
-                current_index = index;
-            }
+            // A cheaper entry for this node was already handled
+            continue;
         }
 
-        if (current_index == 1)
+        current_index = open_node.index;
+
+        if (current_index == finish_index)
         {
             path_found = true;
             break;
         }
 
-        graph.nodes[current_index].visited = true;
-        open_list.remove(current_index);
+        current.visited_generation = generation;
+        ++query.expanded_nodes;
+        ++expanded;
+
+        if (current_index == start_index)
+        {
+            for (auto& edge : query.start_edges)
+            {
+                relax(current_index, edge.target, edge.cost);
+            }
+
+            continue;
+        }
+
+        for (unsigned edge = graph.edge_offsets[current_index]; edge < graph.edge_offsets[current_index + 1]; ++edge)
+        {
+            relax(current_index, graph.edges[edge].target, graph.edges[edge].cost);
+        }
+
+        if (query.finish_costs[current_index] != std::numeric_limits<float>::infinity())
+        {
+            relax(current_index, finish_index, query.finish_costs[current_index]);
+        }
+    }
+
+    if (!path_found)
+    {
+        // No path available?
+        cerr << "Cannot find path\n";
+        query.status = PathStatus::Failed;
+        return query.status;
+    }
+
+    while (current_index != start_index)
+    {
+        query.path.push_back(position(current_index));
+        current_index = query.states[current_index].parent;
+    }
+
+    std::reverse(query.path.begin(), query.path.end());
+
+    query.status = PathStatus::Found;
+    return query.status;
+}
+
+const std::vector<sf::Vector2f>& GetPath(const PathingGraph& graph, PathingQuery& query)
+{
+    BeginPath(graph, query);
+    ContinuePath(graph, query, std::numeric_limits<unsigned>::max());
+
+    return query.path;
+}
+
+HierarchicalPathingGraph CreateHierarchicalPathingGraph(const ObstacleGrid& obstacles, sf::FloatRect bounds, sf::Vector2f entity_size, float cluster_size)
+{
+    HierarchicalPathingGraph hierarchy;
+    hierarchy.bounds = bounds;
+    hierarchy.cluster_size = cluster_size;
+    hierarchy.columns = std::max(1, static_cast<int>(std::ceil(bounds.width / cluster_size)));
+    hierarchy.rows = std::max(1, static_cast<int>(std::ceil(bounds.height / cluster_size)));
 
-        for (auto& [neighbor_index, cost_from_current] : graph.nodes[current_index].connections)
+    PathingGraph& graph = hierarchy.graph;
+    float clearance = (std::max(entity_size.x, entity_size.y) / 2) * 1.25f;
+    graph.clearance = clearance;
+    graph.nodes = createCornerNodes(obstacles, clearance);
+
+    int cluster_count = hierarchy.columns * hierarchy.rows;
+    std::vector<std::vector<int>> members(cluster_count);
+
+    for (unsigned i = 0; i < graph.nodes.size(); ++i)
+    {
+        members[getCluster(hierarchy, graph.nodes[i])].push_back(i);
+    }
+
+    std::vector<sf::Vector2f> portals;
+    for (int row = 0; row < hierarchy.rows; ++row)
+    {
+        for (int column = 0; column < hierarchy.columns; ++column)
         {
-            if (!graph.nodes[neighbor_index].visited)
+            int cluster = row * hierarchy.columns + column;
+            float left = bounds.left + column * cluster_size;
+            float top = bounds.top + row * cluster_size;
+            float width = std::min(cluster_size, bounds.left + bounds.width - left);
+            float height = std::min(cluster_size, bounds.top + bounds.height - top);
+
+            // Each cluster owns the borders to its right and below
+            if (column + 1 < hierarchy.columns)
             {
-                float new_g_cost = graph.nodes[current_index].g_cost + cost_from_current;
-                float new_f_cost = new_g_cost + graph.nodes[neighbor_index].h_cost;
-                if (!graph.nodes[neighbor_index].checked || graph.nodes[neighbor_index].f_cost > new_f_cost)
+                portals.clear();
+                addBorderPortals(obstacles, sf::Vector2f{left + cluster_size, top}, sf::Vector2f{0, 1}, height, clearance, portals);
+                for (auto& portal : portals)
                 {
-                    graph.nodes[neighbor_index].g_cost = new_g_cost;
-                    graph.nodes[neighbor_index].f_cost = new_f_cost;
-                    graph.nodes[neighbor_index].parent = current_index;
+                    members[cluster].push_back(graph.nodes.size());
+                    members[cluster + 1].push_back(graph.nodes.size());
+                    graph.nodes.push_back(portal);
                 }
+            }
 
-                if (!graph.nodes[neighbor_index].checked)
+            if (row + 1 < hierarchy.rows)
+            {
+                portals.clear();
+                addBorderPortals(obstacles, sf::Vector2f{left, top + cluster_size}, sf::Vector2f{1, 0}, width, clearance, portals);
+                for (auto& portal : portals)
                 {
-                    graph.nodes[neighbor_index].checked = true;
-                    open_list.push_back(neighbor_index);
+                    members[cluster].push_back(graph.nodes.size());
+                    members[cluster + hierarchy.columns].push_back(graph.nodes.size());
+                    graph.nodes.push_back(portal);
                 }
             }
         }
     }
 
-    if (path_found)
+    hierarchy.cluster_offsets.resize(cluster_count + 1);
+    hierarchy.cluster_offsets[0] = 0;
+    for (int i = 0; i < cluster_count; ++i)
+    {
+        // Portals are added out of order relative to their neighbouring clusters
+        std::sort(members[i].begin(), members[i].end());
+        hierarchy.cluster_offsets[i + 1] = hierarchy.cluster_offsets[i] + members[i].size();
+        hierarchy.cluster_nodes.insert(hierarchy.cluster_nodes.end(), members[i].begin(), members[i].end());
+    }
+
+    // Sight lines never leave a cluster, so the cost of each test is bounded by the cluster size instead of the region size
+    float sight_width = clearance - 1;
+    std::vector<std::vector<std::pair<int, int>>> visible(cluster_count);
+
+    runTasks(cluster_count, 1, [&](unsigned cluster)
     {
-        while (current_index != 0)
+        auto& nodes = members[cluster];
+        for (unsigned a = 0; a < nodes.size(); ++a)
         {
-            PathingNode& current = graph.nodes[current_index];
-            path.push_front(current.position);
-            current_index = current.parent;
+            for (unsigned b = a + 1; b < nodes.size(); ++b)
+            {
+                if (hasLineOfSight(obstacles, graph.nodes[nodes[a]], graph.nodes[nodes[b]], sight_width))
+                {
+                    visible[cluster].push_back({nodes[a], nodes[b]});
+                }
+            }
         }
+    });
+
+    std::vector<std::pair<int, int>> connections;
+    for (auto& pairs : visible)
+    {
+        connections.insert(connections.end(), pairs.begin(), pairs.end());
     }
 
-    return path;
+    // Two portals on the same border share both of their clusters
+    std::sort(connections.begin(), connections.end());
+    connections.erase(std::unique(connections.begin(), connections.end()), connections.end());
+
+    packEdges(graph, connections);
+
+    return hierarchy;
 }
 
-std::vector<uint16_t> GetPath(std::vector<DjikstraNode> nodes, uint16_t start, uint16_t finish)
+void AppendPathingGraph(sf::Vector2f start, sf::Vector2f finish, const ObstacleGrid& obstacles, sf::FloatRect entity_bounds, const HierarchicalPathingGraph& graph, PathingQuery& query)
 {
-    uint16_t current = finish;
-
-    for (auto& node : nodes)
+    query.start = start;
+    query.finish = finish;
+    query.start_edges.clear();
+    query.finish_costs.assign(graph.graph.nodes.size(), std::numeric_limits<float>::infinity());
+    query.tested_nodes = 0;
+
+    query.direct = HasLineOfSight(obstacles, entity_bounds, start, finish);
+    if (query.direct)
     {
-        node.cost = std::numeric_limits<float>::infinity();
-        node.visited = false;
+        return;
     }
 
-    nodes[current].cost = 0;
+    float sight_width = graph.graph.clearance - 1;
 
-    while (current != start)
+    // Only nodes in the surrounding clusters are tested, widening the search if the endpoint's own cluster is walled off
+    for (int radius = 0; radius <= 1 && query.start_edges.empty(); ++radius)
     {
-        if (nodes[current].visited)
+        gatherClusterNodes(graph, start, radius, query.candidate_nodes);
+        query.tested_nodes += query.candidate_nodes.size();
+        for (int node : query.candidate_nodes)
         {
-            cerr << "No possible path from node " << start << " to node " << finish << endl;
-            return std::vector<uint16_t>();
+            if (HasLineOfSight(obstacles, entity_bounds, start, graph.graph.nodes[node]))
+            {
+                query.start_edges.push_back(PathingEdge{node, static_cast<float>(Distance(start, graph.graph.nodes[node]))});
+            }
         }
+    }
 
-        nodes[current].visited = true;
-
-        for (auto& [index, cost] : nodes[current].connections)
+    bool finish_visible = false;
+    for (int radius = 0; radius <= 1 && !finish_visible; ++radius)
+    {
+        gatherClusterNodes(graph, finish, radius, query.candidate_nodes);
+        query.tested_nodes += query.candidate_nodes.size();
+        for (int node : query.candidate_nodes)
         {
-            if (nodes[current].cost + cost < nodes[index].cost)
+            if (hasLineOfSight(obstacles, finish, graph.graph.nodes[node], sight_width))
             {
-                nodes[index].cost = nodes[current].cost + cost;
-                nodes[index].parent = current;
+                query.finish_costs[node] = Distance(finish, graph.graph.nodes[node]);
+                finish_visible = true;
             }
         }
+    }
+}
+
+PathStatus ContinuePath(const HierarchicalPathingGraph& graph, const ObstacleGrid& obstacles, PathingQuery& query, unsigned expansion_budget)
+{
+    if (ContinuePath(graph.graph, query, expansion_budget) != PathStatus::Found)
+    {
+        return query.status;
+    }
+
+    std::vector<sf::Vector2f>& path = query.path;
 
-        float minimum = std::numeric_limits<float>::infinity();
-        for (unsigned i = 0; i < nodes.size(); ++i)
+    // The abstract path is forced through portals, so pull it tight by skipping any waypoints that can be seen past
+    float sight_width = graph.graph.clearance - 1;
+    sf::Vector2f anchor = query.start;
+    unsigned kept = 0;
+    unsigned current = 0;
+
+    while (current < path.size())
+    {
+        unsigned furthest = current;
+        for (unsigned candidate = std::min<unsigned>(path.size() - 1, current + REFINE_WINDOW); candidate > current; --candidate)
         {
-            DjikstraNode& node = nodes[i];
-            if (!node.visited && node.cost < minimum)
+            if (hasLineOfSight(obstacles, anchor, path[candidate], sight_width))
             {
-                current = i;
-                minimum = node.cost;
+                furthest = candidate;
+                break;
             }
         }
+
+        anchor = path[furthest];
+        path[kept++] = anchor;
+        current = furthest + 1;
     }
 
-    std::vector<uint16_t> path;
+    path.resize(kept);
 
-    while (current != finish)
-    {
-        path.push_back(current);
-        current = nodes[current].parent;
-    }
-    path.push_back(finish);
+    return query.status;
+}
+
+const std::vector<sf::Vector2f>& GetPath(const HierarchicalPathingGraph& graph, const ObstacleGrid& obstacles, PathingQuery& query)
+{
+    BeginPath(graph.graph, query);
+    ContinuePath(graph, obstacles, query, std::numeric_limits<unsigned>::max());
 
-    return path;
+    return query.path;
 }
 
 } // util
@@ -0,0 +1,282 @@
+/**************************************************************************************************
+ *  File:       rect_batch.cpp
+ *
+ *  Purpose:    Rectangles stored as coordinate arrays, so one segment can be tested against several at once
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "rect_batch.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+namespace util
+{
+
+namespace {
+
+// Everything about the segment that is shared by every rect it is tested against
+struct Segment
+{
+    sf::Vector2f p1;
+    sf::Vector2f p2;
+    float slope;
+    bool vertical;
+    bool horizontal;
+};
+
+Segment makeSegment(LineSegment line)
+{
+    return Segment{line.p1, line.p2, (line.p2.y - line.p1.y) / (line.p2.x - line.p1.x), line.p1.x == line.p2.x, line.p1.y == line.p2.y};
+}
+
+// The same tests as Intersects(sf::FloatRect, LineSegment), in the same order, so every lane agrees with it exactly
+bool intersects(float left, float top, float right, float bottom, const Segment& s)
+{
+    if ((s.p1.x < left && s.p2.x < left) || (s.p1.x > right && s.p2.x > right))
+    {
+        return false;
+    }
+
+    if ((s.p1.y < top && s.p2.y < top) || (s.p1.y > bottom && s.p2.y > bottom))
+    {
+        return false;
+    }
+
+    if (s.vertical && s.p1.x >= left && s.p1.x <= right)
+    {
+        return true;
+    }
+
+    if (s.horizontal && s.p1.y >= top && s.p1.y <= bottom)
+    {
+        return true;
+    }
+
+    auto crosses = [](float edge, float a, float b) { return (edge >= a && edge <= b) || (edge >= b && edge <= a); };
+
+    if (crosses(top, s.p1.y, s.p2.y))
+    {
+        float x = (top - s.p2.y) / s.slope + s.p2.x;
+        if (x >= left && x <= right)
+        {
+            return true;
+        }
+    }
+
+    if (crosses(bottom, s.p1.y, s.p2.y))
+    {
+        float x = (bottom - s.p2.y) / s.slope + s.p2.x;
+        if (x >= left && x <= right)
+        {
+            return true;
+        }
+    }
+
+    if (crosses(left, s.p1.x, s.p2.x))
+    {
+        float y = s.slope * (left - s.p2.x) + s.p2.y;
+        if (y >= top && y <= bottom)
+        {
+            return true;
+        }
+    }
+
+    if (crosses(right, s.p1.x, s.p2.x))
+    {
+        float y = s.slope * (right - s.p2.x) + s.p2.y;
+        if (y >= top && y <= bottom)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#if defined(__AVX__)
+
+struct Lanes
+{
+    using Vector = __m256;
+    static constexpr unsigned WIDTH = 8;
+
+    static Vector Load(const float* values) { return _mm256_loadu_ps(values); }
+    static Vector Set(float value) { return _mm256_set1_ps(value); }
+    static Vector Zero() { return _mm256_setzero_ps(); }
+    static Vector Less(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Vector Greater(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Vector LessEqual(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Vector GreaterEqual(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Vector And(Vector a, Vector b) { return _mm256_and_ps(a, b); }
+    static Vector Or(Vector a, Vector b) { return _mm256_or_ps(a, b); }
+    static Vector AndNot(Vector a, Vector b) { return _mm256_andnot_ps(a, b); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector Subtract(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector Multiply(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+    static Vector Divide(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+    static int Mask(Vector a) { return _mm256_movemask_ps(a); }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+struct Lanes
+{
+    using Vector = __m128;
+    static constexpr unsigned WIDTH = 4;
+
+    static Vector Load(const float* values) { return _mm_loadu_ps(values); }
+    static Vector Set(float value) { return _mm_set1_ps(value); }
+    static Vector Zero() { return _mm_setzero_ps(); }
+    static Vector Less(Vector a, Vector b) { return _mm_cmplt_ps(a, b); }
+    static Vector Greater(Vector a, Vector b) { return _mm_cmpgt_ps(a, b); }
+    static Vector LessEqual(Vector a, Vector b) { return _mm_cmple_ps(a, b); }
+    static Vector GreaterEqual(Vector a, Vector b) { return _mm_cmpge_ps(a, b); }
+    static Vector And(Vector a, Vector b) { return _mm_and_ps(a, b); }
+    static Vector Or(Vector a, Vector b) { return _mm_or_ps(a, b); }
+    static Vector AndNot(Vector a, Vector b) { return _mm_andnot_ps(a, b); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector Subtract(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector Multiply(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    static Vector Divide(Vector a, Vector b) { return _mm_div_ps(a, b); }
+    static int Mask(Vector a) { return _mm_movemask_ps(a); }
+};
+
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#define RECT_BATCH_LANES
+
+// Returns a bit per rect, for rects index to index + Lanes::WIDTH - 1. Every branch of the scalar test is
+// evaluated and masked, so lanes give the same answer whichever way the scalar test would have exited.
+int intersectMask(const RectBatch& batch, unsigned index, const Segment& s)
+{
+    using L = Lanes;
+
+    L::Vector left = L::Load(&batch.lefts[index]);
+    L::Vector top = L::Load(&batch.tops[index]);
+    L::Vector right = L::Load(&batch.rights[index]);
+    L::Vector bottom = L::Load(&batch.bottoms[index]);
+
+    L::Vector p1x = L::Set(s.p1.x);
+    L::Vector p1y = L::Set(s.p1.y);
+    L::Vector p2x = L::Set(s.p2.x);
+    L::Vector p2y = L::Set(s.p2.y);
+    L::Vector slope = L::Set(s.slope);
+
+    L::Vector outside = L::Or(
+        L::Or(L::And(L::Less(p1x, left), L::Less(p2x, left)), L::And(L::Greater(p1x, right), L::Greater(p2x, right))),
+        L::Or(L::And(L::Less(p1y, top), L::Less(p2y, top)), L::And(L::Greater(p1y, bottom), L::Greater(p2y, bottom))));
+
+    L::Vector hit = L::Zero();
+
+    if (s.vertical)
+    {
+        hit = L::Or(hit, L::And(L::GreaterEqual(p1x, left), L::LessEqual(p1x, right)));
+    }
+
+    if (s.horizontal)
+    {
+        hit = L::Or(hit, L::And(L::GreaterEqual(p1y, top), L::LessEqual(p1y, bottom)));
+    }
+
+    auto crosses = [](L::Vector edge, L::Vector a, L::Vector b)
+    {
+        return L::Or(L::And(L::GreaterEqual(edge, a), L::LessEqual(edge, b)), L::And(L::GreaterEqual(edge, b), L::LessEqual(edge, a)));
+    };
+
+    auto horizontal_edge = [&](L::Vector edge)
+    {
+        L::Vector x = L::Add(L::Divide(L::Subtract(edge, p2y), slope), p2x);
+        return L::And(crosses(edge, p1y, p2y), L::And(L::GreaterEqual(x, left), L::LessEqual(x, right)));
+    };
+
+    auto vertical_edge = [&](L::Vector edge)
+    {
+        L::Vector y = L::Add(L::Multiply(slope, L::Subtract(edge, p2x)), p2y);
+        return L::And(crosses(edge, p1x, p2x), L::And(L::GreaterEqual(y, top), L::LessEqual(y, bottom)));
+    };
+
+    hit = L::Or(hit, L::Or(horizontal_edge(top), horizontal_edge(bottom)));
+    hit = L::Or(hit, L::Or(vertical_edge(left), vertical_edge(right)));
+
+    return L::Mask(L::AndNot(outside, hit));
+}
+
+#endif
+
+} // anonymous namespace
+
+void AddRect(RectBatch& batch, sf::FloatRect rect)
+{
+    batch.lefts.push_back(rect.left);
+    batch.tops.push_back(rect.top);
+    batch.rights.push_back(rect.left + rect.width);
+    batch.bottoms.push_back(rect.top + rect.height);
+}
+
+void ClearRects(RectBatch& batch)
+{
+    batch.lefts.clear();
+    batch.tops.clear();
+    batch.rights.clear();
+    batch.bottoms.clear();
+}
+
+bool IntersectsAny(const RectBatch& batch, unsigned first, unsigned count, LineSegment line)
+{
+    Segment segment = makeSegment(line);
+    unsigned index = first;
+    unsigned end = first + count;
+
+#ifdef RECT_BATCH_LANES
+    for (; index + Lanes::WIDTH <= end; index += Lanes::WIDTH)
+    {
+        if (intersectMask(batch, index, segment) != 0)
+        {
+            return true;
+        }
+    }
+#endif
+
+    // Scalar fallback, also used for the remainder that does not fill a vector
+    for (; index < end; ++index)
+    {
+        if (intersects(batch.lefts[index], batch.tops[index], batch.rights[index], batch.bottoms[index], segment))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Intersects(const RectBatch& batch, LineSegment line, std::vector<uint8_t>& out_hits)
+{
+    Segment segment = makeSegment(line);
+    unsigned index = 0;
+    unsigned end = batch.lefts.size();
+    out_hits.assign(end, 0);
+
+#ifdef RECT_BATCH_LANES
+    for (; index + Lanes::WIDTH <= end; index += Lanes::WIDTH)
+    {
+        int mask = intersectMask(batch, index, segment);
+        for (unsigned lane = 0; mask != 0; ++lane, mask >>= 1)
+        {
+            out_hits[index + lane] = mask & 1;
+        }
+    }
+#endif
+
+    for (; index < end; ++index)
+    {
+        out_hits[index] = intersects(batch.lefts[index], batch.tops[index], batch.rights[index], batch.bottoms[index], segment);
+    }
+}
+
+} // util
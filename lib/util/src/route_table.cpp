@@ -0,0 +1,182 @@
+/**************************************************************************************************
+ *  File:       route_table.cpp
+ *
+ *  Purpose:    Precomputed shortest routes between every pair of nodes in a small, static graph
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "route_table.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using std::cerr, std::endl;
+
+namespace util
+{
+
+namespace {
+
+struct OpenRoute
+{
+    float cost;
+    uint16_t node;
+};
+
+bool inRange(const RouteTable& table, uint16_t start, uint16_t finish)
+{
+    return start < table.node_count && finish < table.node_count;
+}
+
+} // anonymous namespace
+
+RouteTable CreateRouteTable(unsigned node_count, const std::vector<RouteLink>& links)
+{
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+
+    RouteTable table;
+    table.node_count = node_count;
+    table.link_costs.assign(node_count * node_count, infinity);
+
+    std::vector<unsigned> degrees(node_count, 0);
+    for (auto& link : links)
+    {
+        if (link.start >= node_count || link.finish >= node_count)
+        {
+            cerr << "Route link out of range: " << link.start << " - " << link.finish << endl;
+            continue;
+        }
+
+        ++degrees[link.start];
+        ++degrees[link.finish];
+        table.link_costs[link.start * node_count + link.finish] = link.cost;
+        table.link_costs[link.finish * node_count + link.start] = link.cost;
+    }
+
+    table.edge_offsets.resize(node_count + 1);
+    table.edge_offsets[0] = 0;
+    for (unsigned i = 0; i < node_count; ++i)
+    {
+        table.edge_offsets[i + 1] = table.edge_offsets[i] + degrees[i];
+    }
+
+    std::vector<unsigned> cursors(table.edge_offsets.begin(), table.edge_offsets.end() - 1);
+    table.edges.resize(table.edge_offsets.back());
+    for (auto& link : links)
+    {
+        if (link.start >= node_count || link.finish >= node_count)
+        {
+            continue;
+        }
+
+        table.edges[cursors[link.start]++] = RouteEdge{link.finish, link.cost};
+        table.edges[cursors[link.finish]++] = RouteEdge{link.start, link.cost};
+    }
+
+    table.route_costs.resize(node_count * node_count);
+    table.next_hops.resize(node_count * node_count);
+
+    std::vector<float> costs;
+    std::vector<int> first_hops;
+    for (unsigned source = 0; source < node_count; ++source)
+    {
+        FindShortestRoutes(table, source, costs, first_hops);
+        std::copy(costs.begin(), costs.end(), table.route_costs.begin() + source * node_count);
+        std::copy(first_hops.begin(), first_hops.end(), table.next_hops.begin() + source * node_count);
+    }
+
+    return table;
+}
+
+void FindShortestRoutes(const RouteTable& table, uint16_t source, std::vector<float>& out_costs, std::vector<int>& out_first_hops)
+{
+    auto compare = [](const OpenRoute& lhs, const OpenRoute& rhs) { return lhs.cost > rhs.cost; };
+
+    out_costs.assign(table.node_count, std::numeric_limits<float>::infinity());
+    out_first_hops.assign(table.node_count, -1);
+
+    if (source >= table.node_count)
+    {
+        return;
+    }
+
+    std::vector<OpenRoute> open_list;
+    out_costs[source] = 0;
+    open_list.push_back(OpenRoute{0, source});
+
+    while (!open_list.empty())
+    {
+        std::pop_heap(open_list.begin(), open_list.end(), compare);
+        OpenRoute current = open_list.back();
+        open_list.pop_back();
+
+        if (current.cost > out_costs[current.node])
+        {
+            continue;
+        }
+
+        for (unsigned i = table.edge_offsets[current.node]; i < table.edge_offsets[current.node + 1]; ++i)
+        {
+            const RouteEdge& edge = table.edges[i];
+            float cost = current.cost + edge.cost;
+
+            if (cost < out_costs[edge.target])
+            {
+                out_costs[edge.target] = cost;
+                // The first step out of the source is carried along every route that continues through it
+                out_first_hops[edge.target] = (current.node == source) ? edge.target : out_first_hops[current.node];
+                open_list.push_back(OpenRoute{cost, edge.target});
+                std::push_heap(open_list.begin(), open_list.end(), compare);
+            }
+        }
+    }
+}
+
+bool IsAdjacent(const RouteTable& table, uint16_t start, uint16_t finish)
+{
+    return std::isfinite(GetLinkCost(table, start, finish));
+}
+
+float GetLinkCost(const RouteTable& table, uint16_t start, uint16_t finish)
+{
+    if (!inRange(table, start, finish))
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return table.link_costs[start * table.node_count + finish];
+}
+
+float GetRouteCost(const RouteTable& table, uint16_t start, uint16_t finish)
+{
+    if (!inRange(table, start, finish))
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return table.route_costs[start * table.node_count + finish];
+}
+
+std::vector<uint16_t> GetRoute(const RouteTable& table, uint16_t start, uint16_t finish)
+{
+    if (!inRange(table, start, finish) || !std::isfinite(table.route_costs[start * table.node_count + finish]))
+    {
+        cerr << "No possible path from node " << start << " to node " << finish << endl;
+        return std::vector<uint16_t>();
+    }
+
+    std::vector<uint16_t> route{start};
+    uint16_t current = start;
+
+    while (current != finish)
+    {
+        current = table.next_hops[current * table.node_count + finish];
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+} // util
@@ -0,0 +1,83 @@
+/**************************************************************************************************
+ *  File:       slot_map.cpp
+ *
+ *  Purpose:    Maps entity ids to their index in a dense array in constant time, with generations so
+ *              a handle to an erased entity is never mistaken for whatever takes its place
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "slot_map.h"
+
+namespace util
+{
+
+SlotHandle InsertSlot(SlotMap& map, uint16_t id, unsigned index)
+{
+    if (id >= map.indices.size())
+    {
+        map.indices.resize(id + 1, SLOT_NOT_FOUND);
+        map.generations.resize(id + 1, 0);
+    }
+
+    map.indices[id] = index;
+
+    return SlotHandle{id, map.generations[id]};
+}
+
+void MoveSlot(SlotMap& map, uint16_t id, unsigned index)
+{
+    if (id < map.indices.size() && map.indices[id] != SLOT_NOT_FOUND)
+    {
+        map.indices[id] = index;
+    }
+}
+
+void EraseSlot(SlotMap& map, uint16_t id)
+{
+    if (id < map.indices.size() && map.indices[id] != SLOT_NOT_FOUND)
+    {
+        map.indices[id] = SLOT_NOT_FOUND;
+        ++map.generations[id];
+    }
+}
+
+void ClearSlots(SlotMap& map)
+{
+    for (unsigned id = 0; id < map.indices.size(); ++id)
+    {
+        EraseSlot(map, static_cast<uint16_t>(id));
+    }
+}
+
+unsigned FindSlot(const SlotMap& map, uint16_t id)
+{
+    if (id >= map.indices.size())
+    {
+        return SLOT_NOT_FOUND;
+    }
+
+    return map.indices[id];
+}
+
+unsigned FindSlot(const SlotMap& map, SlotHandle handle)
+{
+    if (handle.id >= map.indices.size() || map.generations[handle.id] != handle.generation)
+    {
+        return SLOT_NOT_FOUND;
+    }
+
+    return map.indices[handle.id];
+}
+
+SlotHandle GetSlotHandle(const SlotMap& map, uint16_t id)
+{
+    if (id >= map.indices.size())
+    {
+        return SlotHandle{id, 0};
+    }
+
+    return SlotHandle{id, map.generations[id]};
+}
+
+} // util
@@ -0,0 +1,109 @@
+/**************************************************************************************************
+ *  File:       spatial_hash.cpp
+ *
+ *  Purpose:    A uniform spatial hash over moving points, for neighbor queries between entities
+ *
+ *  Author:     Ryan Berge
+ *
+ *************************************************************************************************/
+#include "spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace util
+{
+
+namespace {
+
+constexpr unsigned MIN_BUCKETS = 64;
+
+int cellOf(const SpatialHash& hash, float coordinate)
+{
+    return static_cast<int>(std::floor(coordinate / hash.cell_size));
+}
+
+unsigned bucketOf(const SpatialHash& hash, int column, int row)
+{
+    uint32_t key = static_cast<uint32_t>(column) * 73856093u ^ static_cast<uint32_t>(row) * 19349663u;
+    return key & hash.bucket_mask;
+}
+
+} // anonymous namespace
+
+void BuildSpatialHash(SpatialHash& hash, const std::vector<sf::Vector2f>& points, float cell_size)
+{
+    // Twice as many buckets as points keeps most occupied cells in a bucket of their own
+    unsigned bucket_count = MIN_BUCKETS;
+    while (bucket_count < points.size() * 2)
+    {
+        bucket_count *= 2;
+    }
+
+    hash.cell_size = cell_size;
+    hash.bucket_mask = bucket_count - 1;
+    hash.bucket_offsets.assign(bucket_count + 1, 0);
+    hash.items.resize(points.size());
+
+    // Count into the slot after each bucket, so the prefix sum leaves every offset at the start of its bucket
+    for (auto& point : points)
+    {
+        ++hash.bucket_offsets[bucketOf(hash, cellOf(hash, point.x), cellOf(hash, point.y)) + 1];
+    }
+
+    for (unsigned i = 0; i < bucket_count; ++i)
+    {
+        hash.bucket_offsets[i + 1] += hash.bucket_offsets[i];
+    }
+
+    std::vector<unsigned>& cursors = hash.visited_buckets;
+    cursors.assign(hash.bucket_offsets.begin(), hash.bucket_offsets.end() - 1);
+    for (unsigned i = 0; i < points.size(); ++i)
+    {
+        hash.items[cursors[bucketOf(hash, cellOf(hash, points[i].x), cellOf(hash, points[i].y))]++] = i;
+    }
+
+    cursors.clear();
+}
+
+void QuerySpatialHash(SpatialHash& hash, sf::FloatRect area, std::vector<unsigned>& out_items)
+{
+    out_items.clear();
+    if (hash.items.empty())
+    {
+        return;
+    }
+
+    int first_column = cellOf(hash, area.left);
+    int last_column = cellOf(hash, area.left + area.width);
+    int first_row = cellOf(hash, area.top);
+    int last_row = cellOf(hash, area.top + area.height);
+
+    // An area covering more cells than there are buckets would visit every bucket anyway
+    int64_t cell_count = static_cast<int64_t>(last_column - first_column + 1) * (last_row - first_row + 1);
+    if (cell_count > hash.bucket_mask)
+    {
+        out_items = hash.items;
+        return;
+    }
+
+    hash.visited_buckets.clear();
+
+    for (int row = first_row; row <= last_row; ++row)
+    {
+        for (int column = first_column; column <= last_column; ++column)
+        {
+            // Two cells of the same query can land in one bucket, which must only be listed once
+            unsigned bucket = bucketOf(hash, column, row);
+            if (std::find(hash.visited_buckets.begin(), hash.visited_buckets.end(), bucket) != hash.visited_buckets.end())
+            {
+                continue;
+            }
+
+            hash.visited_buckets.push_back(bucket);
+            out_items.insert(out_items.end(), hash.items.begin() + hash.bucket_offsets[bucket], hash.items.begin() + hash.bucket_offsets[bucket + 1]);
+        }
+    }
+}
+
+} // util